@@ -633,11 +633,11 @@ int32_t main (int32_t argc_, char** argv_) {
       std::vector<proslam::IntensityFeature> features_right(keypoints_right.size());
       for (uint64_t index = 0; index < features_left.size(); ++index) {
         features_left[index].keypoint   = keypoints_left[index];
-        features_left[index].descriptor = descriptors_left.row(index);
+        features_left[index].descriptor = proslam::Descriptor::fromMat(descriptors_left, index);
       }
       for (uint64_t index = 0; index < features_right.size(); ++index) {
         features_right[index].keypoint   = keypoints_right[index];
-        features_right[index].descriptor = descriptors_right.row(index);
+        features_right[index].descriptor = proslam::Descriptor::fromMat(descriptors_right, index);
       }
 
       //ds sort all input vectors by ascending row positions
@@ -680,7 +680,7 @@ int32_t main (int32_t argc_, char** argv_) {
             if (features_right[index_search_R].keypoint.pt.x >= features_left[idx_L].keypoint.pt.x) {break;}
 
               //ds compute descriptor distance for the stereo match candidates
-              const double distance_hamming = cv::norm(features_left[idx_L].descriptor, features_right[index_search_R].descriptor, SRRG_PROSLAM_DESCRIPTOR_NORM);
+              const double distance_hamming = proslam::HammingDistance::compute(features_left[idx_L].descriptor, features_right[index_search_R].descriptor);
               if(distance_hamming < distance_best) {
                 distance_best = distance_hamming;
                 index_best_R  = index_search_R;
@@ -1,5 +1,6 @@
 #pragma once
 #include "types/definitions.h"
+#include "types/worker_pool.h"
 
 namespace proslam {
 
@@ -41,8 +42,12 @@ public:
   inline const uint64_t numberOfCorrespondences() const {return _number_of_inliers+_number_of_outliers;}
   inline const real totalError() const {return _total_error;}
   inline const bool hasSystemConverged() const {return _has_system_converged;}
+  inline const bool hasExceededTimeBudget() const {return _has_exceeded_time_budget;}
   inline AlignerParameters* parameters() {return _parameters;}
 
+  //! @brief sets worker threads for parallel linearization (not owned, nullptr: serial linearization)
+  void setWorkerPool(WorkerPool* worker_pool_) {_worker_pool = worker_pool_;}
+
 //ds aligner specific
 protected:
 
@@ -56,9 +61,14 @@ protected:
   bool _has_system_converged          = false;
   real _total_error                   = 0;
 
+  //! @brief set if the last alignment was stopped by the time budget (the result is the best pose found so far)
+  bool _has_exceeded_time_budget = false;
+
   //! @brief configurable parameters
   AlignerParameters* _parameters = 0;
 
+  //! @brief worker threads for parallel linearization (not owned)
+  WorkerPool* _worker_pool = nullptr;
 };
 
 //ds class that holds all generic (running) variables used in an aligner - to be used in conjunction with an aligner
@@ -82,6 +92,93 @@ public:
   typedef Eigen::Matrix<real, dimension_, dimension_> DimensionMatrix;
   typedef Eigen::Matrix<real, dimension_, states_> JacobianMatrix;
 
+  //! @brief number of measurements linearized together (fixed, such that the result does not depend on the number of threads)
+  static constexpr Count number_of_measurements_per_chunk = 256;
+
+  //! @brief measurement coordinates of a chunk in structure of arrays layout (one row per coordinate)
+  template<int rows_>
+  using ChunkMatrix = Eigen::Matrix<real, rows_, Eigen::Dynamic, Eigen::RowMajor, rows_, number_of_measurements_per_chunk>;
+  typedef Eigen::Array<real, 1, Eigen::Dynamic, Eigen::RowMajor, 1, number_of_measurements_per_chunk> ChunkArray;
+
+  //! @brief linearization of a contiguous block of measurements with isotropic information (omega = w*I)
+  //! @brief the jacobians and errors of all considered measurements are stacked and weighted with sqrt(w), such that
+  //! @brief H = J'*J and b = J'*e are obtained with a single matrix product per chunk
+  struct LinearizationChunk {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    Eigen::Matrix<real, Eigen::Dynamic, states_, Eigen::ColMajor, dimension_*number_of_measurements_per_chunk, states_> jacobians;
+    Eigen::Matrix<real, Eigen::Dynamic, 1, Eigen::ColMajor, dimension_*number_of_measurements_per_chunk, 1> errors;
+    Count number_of_rows = 0;
+    StateMatrix H;
+    StateVector b;
+    real total_error        = 0;
+    Count number_of_inliers = 0;
+    std::vector<uint8_t> is_inlier;
+  };
+
+//ds helpers
+protected:
+
+  //! @brief linearizes all measurements in chunks of fixed size (in parallel if worker threads are available)
+  //! @brief and reduces the chunks in order into _H, _b and the aggregate statistics
+  //! @param[in] number_of_measurements_ total number of measurements
+  //! @param[in] worker_pool_ worker threads (nullptr: serial)
+  //! @param[in] linearize_chunk_ function (index_begin, number_of_measurements, chunk) filling the stacked system of a chunk
+  //! @param[out] total_error_ sum of the errors of all considered measurements
+  //! @param[out] inliers_ inlier flag for each measurement
+  //! @return number of inliers
+  template<typename LinearizeChunk>
+  Count _linearizeInChunks(const Count& number_of_measurements_,
+                           WorkerPool* worker_pool_,
+                           const LinearizeChunk& linearize_chunk_,
+                           real& total_error_,
+                           std::vector<bool>& inliers_) {
+    const Count number_of_chunks = (number_of_measurements_+number_of_measurements_per_chunk-1)/number_of_measurements_per_chunk;
+    if (_chunks.size() < number_of_chunks) {
+      _chunks.resize(number_of_chunks);
+    }
+
+    //ds linearize each chunk independently
+    auto linearizeChunk = [&](const Index& index_chunk_) {
+      LinearizationChunk& chunk     = _chunks[index_chunk_];
+      const Index index_begin       = index_chunk_*number_of_measurements_per_chunk;
+      const Count number_of_entries = std::min(number_of_measurements_per_chunk, number_of_measurements_-index_begin);
+      chunk.jacobians.resize(dimension_*number_of_entries, states_);
+      chunk.errors.resize(dimension_*number_of_entries);
+      chunk.is_inlier.assign(number_of_entries, 0);
+      chunk.number_of_rows    = 0;
+      chunk.total_error       = 0;
+      chunk.number_of_inliers = 0;
+      linearize_chunk_(index_begin, number_of_entries, chunk);
+      chunk.H.noalias() = chunk.jacobians.topRows(chunk.number_of_rows).transpose()*chunk.jacobians.topRows(chunk.number_of_rows);
+      chunk.b.noalias() = chunk.jacobians.topRows(chunk.number_of_rows).transpose()*chunk.errors.head(chunk.number_of_rows);
+    };
+    if (worker_pool_ && number_of_chunks > 1) {
+      worker_pool_->run(number_of_chunks, linearizeChunk);
+    } else {
+      for (Index index_chunk = 0; index_chunk < number_of_chunks; ++index_chunk) {
+        linearizeChunk(index_chunk);
+      }
+    }
+
+    //ds reduce in chunk order
+    _H.setZero();
+    _b.setZero();
+    total_error_ = 0;
+    Count number_of_inliers = 0;
+    for (Index index_chunk = 0; index_chunk < number_of_chunks; ++index_chunk) {
+      const LinearizationChunk& chunk = _chunks[index_chunk];
+      _H                += chunk.H;
+      _b                += chunk.b;
+      total_error_      += chunk.total_error;
+      number_of_inliers += chunk.number_of_inliers;
+      const Index index_begin = index_chunk*number_of_measurements_per_chunk;
+      for (Index u = 0; u < chunk.is_inlier.size(); ++u) {
+        inliers_[index_begin+u] = chunk.is_inlier[u];
+      }
+    }
+    return number_of_inliers;
+  }
+
 //ds workspace variables
 protected:
 
@@ -90,5 +187,8 @@ protected:
   DimensionMatrix _omega          = DimensionMatrix::Identity();
   JacobianMatrix _jacobian        = JacobianMatrix::Zero();
   StateMatrix _information_matrix = StateMatrix::Identity();
+
+  //! @brief linearization buffers, one per chunk of measurements
+  std::vector<LinearizationChunk, Eigen::aligned_allocator<LinearizationChunk>> _chunks;
 };
 }
@@ -31,6 +31,11 @@ public:
   //ds dynamic weighting
   void setEnableWeightsTranslation(const bool enable_weights_translation_) {_enable_weights_translation = enable_weights_translation_;}
 
+  //! @brief restricts the robust optimization phase of the next alignment to a set of measurements (e.g. inliers of a pose hypothesis)
+  //! @brief excluded measurements are still evaluated and only contribute to the final inlier only phase, the set is reset after convergence
+  //! @param[in] is_inlier_ flag for each measurement of the next alignment (1: contributes, 0: excluded)
+  void setInlierHypothesis(const std::vector<uint8_t>& is_inlier_) {_is_inlier_hypothesis = is_inlier_;}
+
 //ds attributes
 protected:
 
@@ -48,5 +53,8 @@ protected:
   Count _number_of_cols_image = 0;
 
   bool _enable_weights_translation = true;
+
+  //! @brief optional measurement selection for the robust optimization phase (empty: all measurements)
+  std::vector<uint8_t> _is_inlier_hypothesis;
 };
 }
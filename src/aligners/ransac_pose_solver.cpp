@@ -0,0 +1,177 @@
+#include "ransac_pose_solver.h"
+#include "types/landmark.h"
+
+namespace proslam {
+
+RansacPoseSolver::RansacPoseSolver(BaseTrackerParameters* parameters_): _parameters(parameters_) {
+  LOG_INFO(std::cerr << "RansacPoseSolver::RansacPoseSolver|constructed" << std::endl)
+}
+
+RansacPoseSolver::~RansacPoseSolver() {
+  LOG_INFO(std::cerr << "RansacPoseSolver::~RansacPoseSolver|destroyed" << std::endl)
+}
+
+bool RansacPoseSolver::compute(const Frame* frame_previous_,
+                               const Frame* frame_current_,
+                               const TransformMatrix3D& previous_to_current_prior_) {
+  assert(frame_previous_);
+  assert(frame_current_);
+
+  //ds the prior is the initial best hypothesis
+  _previous_to_current  = previous_to_current_prior_;
+  _number_of_inliers    = 0;
+  _number_of_iterations = 0;
+  _is_prior_best        = true;
+
+  //ds gather correspondences - the previous point coordinates are chosen identically to the pose optimization
+  _number_of_measurements = frame_current_->points().size();
+  _is_inlier.assign(_number_of_measurements, 0);
+  _moving.resize(3, _number_of_measurements);
+  _fixed.resize(3, _number_of_measurements);
+  _image_coordinates.resize(2, _number_of_measurements);
+  _sampling_candidates.clear();
+  for (Index u = 0; u < _number_of_measurements; ++u) {
+    const FramePoint* frame_point = frame_current_->points()[u];
+    assert(frame_point->previous());
+    if (frame_point->landmark()) {
+      _moving.col(u) = frame_point->previous()->cameraCoordinatesLeftLandmark();
+    } else {
+      _moving.col(u) = frame_point->previous()->cameraCoordinatesLeft();
+    }
+    _fixed.col(u)             = frame_point->cameraCoordinatesLeft();
+    _image_coordinates(0, u)  = frame_point->imageCoordinatesLeft().x();
+    _image_coordinates(1, u)  = frame_point->imageCoordinatesLeft().y();
+
+    //ds only sample well triangulated points
+    if (_moving(2, u) > 0 && _moving(2, u) < _maximum_reliable_depth_meters &&
+        _fixed(2, u) > 0 && _fixed(2, u) < _maximum_reliable_depth_meters) {
+      _sampling_candidates.push_back(u);
+    }
+  }
+  _camera_calibration_matrix = frame_current_->cameraLeft()->cameraMatrix();
+
+  //ds evaluate the prior
+  real best_error = _evaluate(_previous_to_current, _number_of_inliers);
+  _number_of_inliers_prior = _number_of_inliers;
+  if (_sampling_candidates.size() < 3) {
+    LOG_DEBUG(std::cerr << "RansacPoseSolver::compute|insufficient number of sampling candidates: " << _sampling_candidates.size() << std::endl)
+  } else {
+
+    //ds deterministic sampling for a given frame (identical sequence on every platform and standard library)
+    uint64_t state = 0x9E3779B97F4A7C15 ^ (frame_current_->identifier()+1);
+    auto sampleIndex = [&state](const Count& number_of_candidates_) {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      return static_cast<Index>(state%number_of_candidates_);
+    };
+
+    //ds required number of iterations is adapted to the best inlier ratio found so far (confidence 0.99)
+    const Count number_of_candidates = _sampling_candidates.size();
+    Count number_of_iterations       = _parameters->ransac_maximum_number_of_iterations;
+    std::vector<Index> sample(3);
+    TransformMatrix3D hypothesis(TransformMatrix3D::Identity());
+    while (_number_of_iterations < number_of_iterations) {
+      ++_number_of_iterations;
+
+      //ds draw 3 distinct correspondences
+      sample[0] = _sampling_candidates[sampleIndex(number_of_candidates)];
+      do {sample[1] = _sampling_candidates[sampleIndex(number_of_candidates)];} while (sample[1] == sample[0]);
+      do {sample[2] = _sampling_candidates[sampleIndex(number_of_candidates)];} while (sample[2] == sample[0] || sample[2] == sample[1]);
+      if (!_solve(sample, hypothesis)) {
+        continue;
+      }
+
+      //ds keep the hypothesis if it is better than the current best
+      Count number_of_inliers = 0;
+      const real error = _evaluate(hypothesis, number_of_inliers);
+      if (error < best_error) {
+        best_error           = error;
+        _number_of_inliers   = number_of_inliers;
+        _previous_to_current = hypothesis;
+        _is_prior_best       = false;
+
+        //ds adapt the number of iterations
+        const real inlier_ratio = static_cast<real>(_number_of_inliers)/_number_of_measurements;
+        const real probability_of_valid_sample = inlier_ratio*inlier_ratio*inlier_ratio;
+        if (probability_of_valid_sample > 0.9999) {
+          break;
+        } else if (probability_of_valid_sample > 0) {
+          number_of_iterations = std::min(static_cast<real>(_parameters->ransac_maximum_number_of_iterations),
+                                           std::ceil(std::log(0.01)/std::log(1-probability_of_valid_sample)));
+        }
+      }
+    }
+  }
+
+  //ds compute the inlier set of the best hypothesis
+  _evaluate(_previous_to_current, _number_of_inliers);
+  const real maximum_error_squared = _parameters->ransac_maximum_reprojection_error_pixels*_parameters->ransac_maximum_reprojection_error_pixels;
+  for (Index u = 0; u < _number_of_measurements; ++u) {
+    _is_inlier[u] = (_errors_squared(u) < maximum_error_squared);
+  }
+
+  //ds refine the best hypothesis on all reliable inliers, kept only if it improves the score
+  std::vector<Index> inliers;
+  inliers.reserve(_number_of_inliers);
+  for (const Index& index: _sampling_candidates) {
+    if (_is_inlier[index]) {
+      inliers.push_back(index);
+    }
+  }
+  TransformMatrix3D refined(TransformMatrix3D::Identity());
+  if (inliers.size() > 3 && _solve(inliers, refined)) {
+    Count number_of_inliers = 0;
+    const real error = _evaluate(refined, number_of_inliers);
+    if (error < best_error) {
+      _previous_to_current = refined;
+      _number_of_inliers   = number_of_inliers;
+      _is_prior_best       = false;
+      for (Index u = 0; u < _number_of_measurements; ++u) {
+        _is_inlier[u] = (_errors_squared(u) < maximum_error_squared);
+      }
+    }
+  }
+  LOG_DEBUG(std::cerr << "RansacPoseSolver::compute|iterations: " << _number_of_iterations << " inliers: " << _number_of_inliers
+                      << "/" << _number_of_measurements << " prior best: " << _is_prior_best << std::endl)
+  return (_number_of_inliers >= 3);
+}
+
+real RansacPoseSolver::_evaluate(const TransformMatrix3D& previous_to_current_, Count& number_of_inliers_) {
+  const real maximum_error_squared = _parameters->ransac_maximum_reprojection_error_pixels*_parameters->ransac_maximum_reprojection_error_pixels;
+
+  //ds project all points at once
+  _points_in_camera.resize(3, _number_of_measurements);
+  _points_in_camera.noalias() = _camera_calibration_matrix*(previous_to_current_.linear()*_moving);
+  _points_in_camera.colwise() += Vector3(_camera_calibration_matrix*previous_to_current_.translation());
+  const Eigen::Array<real, 1, Eigen::Dynamic> inverse_c = _points_in_camera.row(2).array().inverse();
+  _errors_squared = (_points_in_camera.row(0).array()*inverse_c-_image_coordinates.row(0).array()).square()+
+                    (_points_in_camera.row(1).array()*inverse_c-_image_coordinates.row(1).array()).square();
+
+  //ds points behind the camera are outliers
+  _errors_squared = (_points_in_camera.row(2).array() > 0).select(_errors_squared, maximum_error_squared);
+  number_of_inliers_ = (_errors_squared < maximum_error_squared).count();
+  return _errors_squared.min(maximum_error_squared).sum();
+}
+
+bool RansacPoseSolver::_solve(const std::vector<Index>& indices_, TransformMatrix3D& previous_to_current_) const {
+  Eigen::Matrix<real, 3, Eigen::Dynamic> points_previous(3, indices_.size());
+  Eigen::Matrix<real, 3, Eigen::Dynamic> points_current(3, indices_.size());
+  for (Index u = 0; u < indices_.size(); ++u) {
+    points_previous.col(u) = _moving.col(indices_[u]);
+    points_current.col(u)  = _fixed.col(indices_[u]);
+  }
+
+  //ds reject (nearly) collinear minimal samples
+  if (indices_.size() == 3) {
+    const Vector3 normal = (points_previous.col(1)-points_previous.col(0)).cross(points_previous.col(2)-points_previous.col(0));
+    if (normal.squaredNorm() < 1e-6) {
+      return false;
+    }
+  }
+
+  //ds closed form rigid alignment (Umeyama, without scaling)
+  previous_to_current_.matrix() = Eigen::umeyama(points_previous, points_current, false);
+  return previous_to_current_.matrix().allFinite();
+}
+}
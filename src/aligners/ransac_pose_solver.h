@@ -0,0 +1,93 @@
+#pragma once
+#include "types/frame.h"
+
+namespace proslam {
+
+//ds this class generates a robust initial guess for the frame to frame pose optimization: minimal 3 point hypotheses
+//ds on the stereo triangulated correspondences of two frames are scored by their reprojection error in the current image (RANSAC)
+class RansacPoseSolver {
+
+//ds object handling
+public: EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  //! @brief constructs a solver configured by the tracker parameters
+  //! @param[in] parameters_ tracker parameters (ransac_* settings)
+  RansacPoseSolver(BaseTrackerParameters* parameters_);
+
+  //! @brief default destructor
+  ~RansacPoseSolver();
+
+//ds functionality
+public:
+
+  //! @brief computes the best pose hypothesis for the correspondences (points of the current frame and their previous points)
+  //! @brief the prior is always evaluated as first hypothesis, sampling is deterministic for a given frame
+  //! @param[in] frame_previous_ previous frame
+  //! @param[in] frame_current_ current frame with tracked points
+  //! @param[in] previous_to_current_prior_ motion prior (e.g. from a motion model)
+  //! @return true if a hypothesis with at least 3 inliers was found
+  bool compute(const Frame* frame_previous_,
+               const Frame* frame_current_,
+               const TransformMatrix3D& previous_to_current_prior_);
+
+//ds getters/setters
+public:
+
+  void setMaximumReliableDepthMeters(const real& maximum_reliable_depth_meters_) {_maximum_reliable_depth_meters = maximum_reliable_depth_meters_;}
+  const TransformMatrix3D& previousToCurrent() const {return _previous_to_current;}
+  const std::vector<uint8_t>& inliers() const {return _is_inlier;}
+  const Count& numberOfInliers() const {return _number_of_inliers;}
+  const Count& numberOfInliersPrior() const {return _number_of_inliers_prior;}
+  const Count& numberOfIterations() const {return _number_of_iterations;}
+  const bool& isPriorBest() const {return _is_prior_best;}
+
+//ds helpers
+protected:
+
+  //! @brief evaluates a hypothesis on all correspondences (truncated squared reprojection error)
+  //! @param[in] previous_to_current_ hypothesis to evaluate
+  //! @param[out] number_of_inliers_ number of correspondences with a reprojection error below the threshold
+  //! @return total truncated error (the lower, the better)
+  real _evaluate(const TransformMatrix3D& previous_to_current_, Count& number_of_inliers_);
+
+  //! @brief estimates the rigid transform between the selected correspondences in closed form (least squares)
+  //! @param[in] indices_ correspondences to use (at least 3)
+  //! @param[out] previous_to_current_ estimated transform
+  //! @return false if the configuration is degenerate
+  bool _solve(const std::vector<Index>& indices_, TransformMatrix3D& previous_to_current_) const;
+
+//ds attributes
+protected:
+
+  //! @brief configuration
+  BaseTrackerParameters* _parameters;
+
+  //! @brief only correspondences within this depth (previous and current) are sampled for hypotheses
+  real _maximum_reliable_depth_meters = 15;
+
+  //! @brief correspondences in structure of arrays layout (one column per point): points in the previous camera frame
+  //! @brief (landmark estimate if available), triangulated points in the current camera frame and measured image coordinates
+  Count _number_of_measurements = 0;
+  Eigen::Matrix<real, 3, Eigen::Dynamic, Eigen::RowMajor> _moving;
+  Eigen::Matrix<real, 3, Eigen::Dynamic, Eigen::RowMajor> _fixed;
+  Eigen::Matrix<real, 2, Eigen::Dynamic, Eigen::RowMajor> _image_coordinates;
+  CameraMatrix _camera_calibration_matrix = CameraMatrix::Zero();
+
+  //! @brief correspondences eligible for sampling
+  std::vector<Index> _sampling_candidates;
+
+  //! @brief evaluation buffers
+  Eigen::Matrix<real, 3, Eigen::Dynamic, Eigen::RowMajor> _points_in_camera;
+  Eigen::Array<real, 1, Eigen::Dynamic> _errors_squared;
+
+  //! @brief best hypothesis
+  TransformMatrix3D _previous_to_current = TransformMatrix3D::Identity();
+  std::vector<uint8_t> _is_inlier;
+  Count _number_of_inliers    = 0;
+  Count _number_of_iterations = 0;
+  bool _is_prior_best         = true;
+
+  //! @brief number of inliers of the motion prior (quality reference for the best hypothesis)
+  Count _number_of_inliers_prior = 0;
+};
+}
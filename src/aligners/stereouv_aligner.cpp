@@ -20,49 +20,51 @@ namespace proslam {
     _number_of_measurements = _frame_current->points().size();
     _errors.resize(_number_of_measurements);
     _inliers.resize(_number_of_measurements);
-    _information_vector.resize(_number_of_measurements);
-    _weights_translation.resize(_number_of_measurements, 1);
-    _moving.resize(_number_of_measurements);
-    _fixed.resize(_number_of_measurements);
+    _information.setOnes(_number_of_measurements);
+    _weights_translation.setOnes(_number_of_measurements);
+    _moving.resize(3, _number_of_measurements);
+    _fixed.resize(4, _number_of_measurements);
 
-    //ds fill buffers
+    //ds fill buffers - gathered once such that the linearization does not have to access the framepoints
     for (Index u = 0; u < _number_of_measurements; ++u) {
       const FramePoint* frame_point = _frame_current->points()[u];
-      _information_vector[u].setIdentity();
 
       assert(_frame_current->cameraLeft()->isInFieldOfView(frame_point->imageCoordinatesLeft()));
       assert(_frame_current->cameraRight()->isInFieldOfView(frame_point->imageCoordinatesRight()));
       assert(frame_point->previous());
 
       //ds set fixed part (image coordinates)
-      _fixed[u](0) = frame_point->imageCoordinatesLeft().x();
-      _fixed[u](1) = frame_point->imageCoordinatesLeft().y();
-      _fixed[u](2) = frame_point->imageCoordinatesRight().x();
-      _fixed[u](3) = frame_point->imageCoordinatesRight().y();
+      _fixed(0, u) = frame_point->imageCoordinatesLeft().x();
+      _fixed(1, u) = frame_point->imageCoordinatesLeft().y();
+      _fixed(2, u) = frame_point->imageCoordinatesRight().x();
+      _fixed(3, u) = frame_point->imageCoordinatesRight().y();
 
       //ds if we have a landmark
       if (frame_point->landmark()) {
 
         //ds prefer landmark estimate
-        _moving[u] = frame_point->previous()->cameraCoordinatesLeftLandmark();
+        _moving.col(u) = frame_point->previous()->cameraCoordinatesLeftLandmark();
 
         //ds increase weight linear in the number of updates
-        _information_vector[u] *= (1+frame_point->landmark()->numberOfUpdates());
+        _information(u) *= (1+frame_point->landmark()->numberOfUpdates());
       } else {
 
         //ds set moving part (3D point coordinates)
-        _moving[u] = frame_point->previous()->cameraCoordinatesLeft();
+        _moving.col(u) = frame_point->previous()->cameraCoordinatesLeft();
       }
 
       //ds scale information proportional to disparity of the measurement (the bigger, the closer, the better the triangulation)
-      _information_vector[u] *= std::log(1+frame_point->disparityPixels())/(1+std::fabs(frame_point->epipolarOffset()));
+      _information(u) *= std::log(1+frame_point->disparityPixels())/(1+std::fabs(frame_point->epipolarOffset()));
     }
 
     //ds if individual weighting is desired
     if (_enable_weights_translation) {
-      for (Index u = 0; u < _number_of_measurements; ++u) {
-        _weights_translation[u] = _maximum_reliable_depth_meters/_moving[u].z();
-      }
+      _weights_translation = _maximum_reliable_depth_meters/_moving.row(2).array();
+    }
+
+    //ds an inlier hypothesis is only valid for the measurements it was computed for
+    if (_is_inlier_hypothesis.size() != _number_of_measurements) {
+      _is_inlier_hypothesis.clear();
     }
 
     //ds wrappers for optimization
@@ -74,68 +76,67 @@ namespace proslam {
 
   //ds linearize the system: to be called inside oneRound
   void StereoUVAligner::linearize(const bool& ignore_outliers_) {
+    _number_of_inliers = _linearizeInChunks(_number_of_measurements, _worker_pool,
+                                            [this, &ignore_outliers_](const Index& index_begin_, const Count& number_of_entries_, LinearizationChunk& chunk_) {
+      _linearizeChunk(index_begin_, number_of_entries_, ignore_outliers_, chunk_);
+    }, _total_error, _inliers);
 
-    //ds initialize setup
-    _H.setZero();
-    _b.setZero();
-    _number_of_inliers = 0;
-    _total_error       = 0;
-
-    //ds loop over all current framepoints (assuming that each of them has a previous one)
-    for (Index u = 0; u < _number_of_measurements; ++u) {
-      _errors[u]  = -1;
-      _inliers[u] = false;
-      _omega      = _information_vector[u];
+    //ds update statistics
+    _number_of_outliers = _number_of_measurements-_number_of_inliers;
+  }
 
-      //ds compute the point in the camera frame - prefering a landmark estimate if available
-      const PointCoordinates sampled_point_in_camera_left = _previous_to_current*_moving[u];
-      if (sampled_point_in_camera_left.z() <= _minimum_depth) {
+  void StereoUVAligner::_linearizeChunk(const Index& index_begin_, const Count& number_of_entries_, const bool& ignore_outliers_, LinearizationChunk& chunk_) {
+
+    //ds compute all points of the chunk in the camera frame at once - prefering a landmark estimate if available
+    ChunkMatrix<3> sampled_points_in_camera_left(3, number_of_entries_);
+    sampled_points_in_camera_left.noalias() = _previous_to_current.linear()*_moving.middleCols(index_begin_, number_of_entries_);
+    sampled_points_in_camera_left.colwise() += _previous_to_current.translation();
+
+    //ds retrieve homogeneous projections (the right projection is shifted by the baseline)
+    ChunkMatrix<3> sampled_abc_in_camera_left(3, number_of_entries_);
+    sampled_abc_in_camera_left.noalias() = _camera_calibration_matrix*sampled_points_in_camera_left;
+    const ChunkArray inverse_sampled_c_left  = sampled_abc_in_camera_left.row(2).array().inverse();
+    const ChunkArray inverse_sampled_c_right = (sampled_abc_in_camera_left.row(2).array()+_offset_camera_right.z()).inverse();
+
+    //ds compute the image coordinates
+    const ChunkArray u_left  = sampled_abc_in_camera_left.row(0).array()*inverse_sampled_c_left;
+    const ChunkArray v_left  = sampled_abc_in_camera_left.row(1).array()*inverse_sampled_c_left;
+    const ChunkArray u_right = (sampled_abc_in_camera_left.row(0).array()+_offset_camera_right.x())*inverse_sampled_c_right;
+    const ChunkArray v_right = (sampled_abc_in_camera_left.row(1).array()+_offset_camera_right.y())*inverse_sampled_c_right;
+
+    //ds compute errors and squared errors (weighted with the isotropic information)
+    const ChunkArray error_u_left  = u_left-_fixed.row(0).segment(index_begin_, number_of_entries_).array();
+    const ChunkArray error_v_left  = v_left-_fixed.row(1).segment(index_begin_, number_of_entries_).array();
+    const ChunkArray error_u_right = u_right-_fixed.row(2).segment(index_begin_, number_of_entries_).array();
+    const ChunkArray error_v_right = v_right-_fixed.row(3).segment(index_begin_, number_of_entries_).array();
+    const ChunkArray chis = _information.segment(index_begin_, number_of_entries_)*
+                            (error_u_left.square()+error_v_left.square()+error_u_right.square()+error_v_right.square());
+
+    //ds assemble the stacked system for all valid measurements
+    for (Index k = 0; k < number_of_entries_; ++k) {
+      const Index u = index_begin_+k;
+      _errors[u] = -1;
+
+      //ds skip points behind the camera and points projected outside of the images
+      if (sampled_points_in_camera_left(2, k) <= _minimum_depth) {
         continue;
       }
-
-      //ds retrieve homogeneous projections
-      const Vector4 sampled_point_in_camera_left_homogeneous(sampled_point_in_camera_left.x(),
-                                                             sampled_point_in_camera_left.y(),
-                                                             sampled_point_in_camera_left.z(),
-                                                             1);
-      const PointCoordinates sampled_abc_in_camera_left  = _camera_calibration_matrix*sampled_point_in_camera_left;
-      const PointCoordinates sampled_abc_in_camera_right = sampled_abc_in_camera_left+_offset_camera_right;
-      const real& sampled_c_left  = sampled_abc_in_camera_left.z();
-      const real& sampled_c_right = sampled_abc_in_camera_right.z();
-
-      //ds compute the image coordinates
-      const PointCoordinates sampled_point_in_image_left  = sampled_abc_in_camera_left/sampled_c_left;
-      const PointCoordinates sampled_point_in_image_right = sampled_abc_in_camera_right/sampled_c_right;
-
-      //ds if the point is outside the image, skip
-      if (sampled_point_in_image_left.x() < 0 || sampled_point_in_image_left.x() > _number_of_cols_image||
-          sampled_point_in_image_left.y() < 0 || sampled_point_in_image_left.y() > _number_of_rows_image) {
+      if (u_left(k) < 0 || u_left(k) > _number_of_cols_image || v_left(k) < 0 || v_left(k) > _number_of_rows_image) {
         continue;
       }
-      if (sampled_point_in_image_right.x() < 0 || sampled_point_in_image_right.x() > _number_of_cols_image||
-          sampled_point_in_image_right.y() < 0 || sampled_point_in_image_right.y() > _number_of_rows_image) {
+      if (u_right(k) < 0 || u_right(k) > _number_of_cols_image || v_right(k) < 0 || v_right(k) > _number_of_rows_image) {
         continue;
       }
-      assert(_frame_current->cameraLeft()->isInFieldOfView(sampled_point_in_image_left));
-      assert(_frame_current->cameraRight()->isInFieldOfView(sampled_point_in_image_right));
-
-      //ds compute error (we compute the vertical error only once, since we assume rectified cameras)
-      const Vector4 error(sampled_point_in_image_left.x()-_fixed[u](0),
-                          sampled_point_in_image_left.y()-_fixed[u](1),
-                          sampled_point_in_image_right.x()-_fixed[u](2),
-                          sampled_point_in_image_right.y()-_fixed[u](3));
-
-      //ds weight all measurements proportional to their distance to the sensor (squared to damp the effect)
-      //const real weight_translation = 1/std::sqrt(depth_meters);
-      //const real weight_translation = _maximum_reliable_depth_meters/depth_meters;
-      //const real weight_translation = exp(-depth_meters/_maximum_reliable_depth_meters);
-      //const real weight_translation = 1; //std::sqrt(frame_point->disparityPixels());
-
-      //ds compute squared error
-      const real chi = error.transpose()*_omega*error;
 
       //ds update error stats
-      _errors[u] = chi;
+      const real& chi = chis(k);
+      _errors[u]      = chi;
+      real omega      = _information(u);
+
+      //ds measurements excluded by an inlier hypothesis are only considered in the inlier only phase
+      if (!ignore_outliers_ && !_is_inlier_hypothesis.empty() && !_is_inlier_hypothesis[u]) {
+        continue;
+      }
 
       //ds check if outlier
       if (chi > _parameters->maximum_error_kernel) {
@@ -144,66 +145,36 @@ namespace proslam {
         }
 
         //ds proportionally reduce information value of the measurement
-        _omega *= _parameters->maximum_error_kernel/chi;
+        omega *= _parameters->maximum_error_kernel/chi;
       } else {
-        _inliers[u] = true;
-        ++_number_of_inliers;
+        chunk_.is_inlier[k] = 1;
+        ++chunk_.number_of_inliers;
       }
 
       //ds update total error
-      _total_error += _errors[u];
-
-      //ds compute the jacobian of the transformation
-      Matrix3_6 jacobian_transform;
-
-      //ds translation contribution (will be scaled with omega)
-//      const real translation_weight = _maximum_reliable_depth_meters/sampled_point_in_camera_left.z();
-      jacobian_transform.block<3,3>(0,0) = _weights_translation[u]*Matrix3::Identity();
-
-      //ds rotation contribution - compensate for inverse depth (far points should have an equally strong contribution as close ones)
-      jacobian_transform.block<3,3>(0,3) = -2*skew(sampled_point_in_camera_left);
-
-      //ds precompute
-      const Matrix3_6 camera_matrix_per_jacobian_transform(_camera_calibration_matrix*jacobian_transform);
-
-      //ds precompute
-      const real inverse_sampled_c_left  = 1/sampled_c_left;
-      const real inverse_sampled_c_right = 1/sampled_c_right;
-      const real inverse_sampled_c_squared_left  = inverse_sampled_c_left*inverse_sampled_c_left;
-      const real inverse_sampled_c_squared_right = inverse_sampled_c_right*inverse_sampled_c_right;
-
-      //ds jacobian parts of the homogeneous division: left
-      Matrix2_3 jacobian_left;
-      jacobian_left << inverse_sampled_c_left, 0, -sampled_abc_in_camera_left.x()*inverse_sampled_c_squared_left,
-                       0, inverse_sampled_c_left, -sampled_abc_in_camera_left.y()*inverse_sampled_c_squared_left;
-
-      //ds we compute only the contribution for the horizontal error: right
-      Matrix2_3 jacobian_right;
-      jacobian_right << inverse_sampled_c_right, 0, -sampled_abc_in_camera_right.x()*inverse_sampled_c_squared_right,
-                        0, inverse_sampled_c_right, -sampled_abc_in_camera_right.y()*inverse_sampled_c_squared_right;
-
-      //ds the last rows of jacobian_left and jacobian_right are identical for perfect, horizontally triangulated points
-      //ds in a horizontal stereo camera configuration
-
-      //ds assemble final jacobian
-      _jacobian.setZero();
-
-      //ds we have to compute the full block
-      _jacobian.block<2,6>(0,0) = jacobian_left*camera_matrix_per_jacobian_transform;
-
-      //ds we only have to compute the horizontal block
-      _jacobian.block<2,6>(2,0) = jacobian_right*camera_matrix_per_jacobian_transform;
-
-      //ds precompute transposed
-      const Matrix6_4 jacobian_transposed(_jacobian.transpose());
-
-      //ds update H and b
-      _H += jacobian_transposed*_omega*_jacobian;
-      _b += jacobian_transposed*_omega*error;
+      chunk_.total_error += chi;
+
+      //ds compute the jacobian of the transformation, projected by the camera matrix
+      //ds translation contribution (will be scaled with omega) and rotation contribution
+      Matrix3_6 camera_matrix_per_jacobian_transform;
+      camera_matrix_per_jacobian_transform.block<3,3>(0,0) = _weights_translation(u)*_camera_calibration_matrix;
+      camera_matrix_per_jacobian_transform.block<3,3>(0,3) = -2*_camera_calibration_matrix*skew(Vector3(sampled_points_in_camera_left.col(k)));
+
+      //ds jacobians of the homogeneous divisions: row i is (P(i)-image_coordinate_i*P(2))/c for P = K*jacobian_transform
+      const real weight        = std::sqrt(omega);
+      const real weight_left   = weight*inverse_sampled_c_left(k);
+      const real weight_right  = weight*inverse_sampled_c_right(k);
+      const Index row          = chunk_.number_of_rows;
+      chunk_.jacobians.row(row)   = weight_left*(camera_matrix_per_jacobian_transform.row(0)-u_left(k)*camera_matrix_per_jacobian_transform.row(2));
+      chunk_.jacobians.row(row+1) = weight_left*(camera_matrix_per_jacobian_transform.row(1)-v_left(k)*camera_matrix_per_jacobian_transform.row(2));
+      chunk_.jacobians.row(row+2) = weight_right*(camera_matrix_per_jacobian_transform.row(0)-u_right(k)*camera_matrix_per_jacobian_transform.row(2));
+      chunk_.jacobians.row(row+3) = weight_right*(camera_matrix_per_jacobian_transform.row(1)-v_right(k)*camera_matrix_per_jacobian_transform.row(2));
+      chunk_.errors(row)   = weight*error_u_left(k);
+      chunk_.errors(row+1) = weight*error_v_left(k);
+      chunk_.errors(row+2) = weight*error_u_right(k);
+      chunk_.errors(row+3) = weight*error_v_right(k);
+      chunk_.number_of_rows += 4;
     }
-
-    //ds update statistics
-    _number_of_outliers = _number_of_measurements-_number_of_inliers;
   }
 
   //ds solve alignment problem for one round
@@ -232,17 +203,56 @@ namespace proslam {
     //ds previous error to check for convergence
     real total_error_previous = 0;
 
+    //ds anytime alignment: the best evaluated pose is kept in case the time budget is exceeded
+    const double time_begin_seconds = srrg_core::getTime();
+    _has_exceeded_time_budget       = false;
+    TransformMatrix3D previous_to_current_best(_previous_to_current);
+    real total_error_best      = std::numeric_limits<real>::max();
+    bool ignore_outliers_best  = false;
+    auto updateBest = [&](const TransformMatrix3D& previous_to_current_evaluated_, const bool& ignore_outliers_) {
+
+      //ds the error of a round is computed for the pose before its update
+      if (_total_error < total_error_best) {
+        total_error_best         = _total_error;
+        previous_to_current_best = previous_to_current_evaluated_;
+        ignore_outliers_best     = ignore_outliers_;
+      }
+
+      //ds check the time budget (0: unbounded)
+      if (_parameters->maximum_time_seconds > 0 && srrg_core::getTime()-time_begin_seconds > _parameters->maximum_time_seconds) {
+        _has_exceeded_time_budget = true;
+      }
+      return _has_exceeded_time_budget;
+    };
+
     //ds start LS
     for (Count iteration = 0; iteration < _parameters->maximum_number_of_iterations; ++iteration) {
+      const TransformMatrix3D previous_to_current_evaluated(_previous_to_current);
       oneRound(false);
+      const bool has_exceeded_time_budget = updateBest(previous_to_current_evaluated, false);
 
       //ds check if converged (no descent required)
       if (_parameters->error_delta_for_convergence > std::fabs(total_error_previous-_total_error)) {
         total_error_previous = _total_error;
+        const bool is_inlier_phase_triggered = (_number_of_inliers > 100 && _number_of_inliers > _number_of_outliers);
+
+        //ds measurements excluded by an inlier hypothesis only rejoin in the inlier only runs - if these are not triggered
+        //ds the hypothesis is dropped and the robust runs continue on all measurements from the current estimate
+        if (!has_exceeded_time_budget && !is_inlier_phase_triggered && !_is_inlier_hypothesis.empty()) {
+          _is_inlier_hypothesis.clear();
+          total_error_best      = std::numeric_limits<real>::max();
+          _has_system_converged = false;
+          continue;
+        }
 
         //ds if we have at least a certain number of inliers and more inliers than outliers - trigger inlier only runs
-        if (_number_of_inliers > 100 && _number_of_inliers > _number_of_outliers) {
+        bool has_exceeded_time_budget_inlier = false;
+        if (!has_exceeded_time_budget && is_inlier_phase_triggered) {
+
+          //ds the inlier only error is not comparable to the robust one
+          total_error_best = std::numeric_limits<real>::max();
           for (Count iteration_inlier = 0; iteration_inlier < _parameters->maximum_number_of_iterations; ++iteration_inlier) {
+            const TransformMatrix3D previous_to_current_evaluated_inlier(_previous_to_current);
             oneRound(true);
 
             //ds check for convergence
@@ -252,19 +262,29 @@ namespace proslam {
             } else {
               total_error_previous = _total_error;
             }
+            if (updateBest(previous_to_current_evaluated_inlier, true)) {
+              has_exceeded_time_budget_inlier = true;
+              break;
+            }
           }
         }
 
         //ds compute information matrix
         _information_matrix = _H;
 
-        //ds system converged
-        _has_system_converged = true;
+        //ds system converged (unless the inlier only runs were stopped by the time budget)
+        _has_system_converged = !has_exceeded_time_budget_inlier;
         break;
       } else {
         total_error_previous = _total_error;
       }
 
+      //ds stop if we ran out of time
+      if (has_exceeded_time_budget) {
+        _has_system_converged = false;
+        break;
+      }
+
       //ds check last iteration
       if(iteration == _parameters->maximum_number_of_iterations-1) {
         _has_system_converged = false;
@@ -274,10 +294,24 @@ namespace proslam {
       }
     }
 
+    //ds if the time budget was exceeded before convergence - return the best evaluated pose with its statistics
+    //ds a converged solution (possibly reached in the same round as the budget) is kept including its final step
+    if (_has_exceeded_time_budget && !_has_system_converged) {
+      _previous_to_current = previous_to_current_best;
+      linearize(ignore_outliers_best);
+      _information_matrix = _H;
+      LOG_DEBUG(std::cerr << "StereoUVAligner::converge|time budget exceeded after " << srrg_core::getTime()-time_begin_seconds
+                << "s - converged: " << _has_system_converged << " total error: " << _total_error
+                << " inliers: " << _number_of_inliers << " outliers: " << _number_of_outliers << std::endl)
+    }
+
+    //ds the inlier hypothesis is consumed
+    _is_inlier_hypothesis.clear();
+
     //ds VISUALIZATION ONLY
     for (Index u = 0; u < _number_of_measurements; ++u) {
       FramePoint* frame_point = _frame_current->points()[u];
-      ImageCoordinates image_coordinates(_camera_calibration_matrix*_previous_to_current*_moving[u]);
+      ImageCoordinates image_coordinates(_camera_calibration_matrix*(_previous_to_current*Vector3(_moving.col(u))));
       image_coordinates /= image_coordinates.z();
       frame_point->setProjectionEstimateLeftOptimized(cv::Point2f(image_coordinates.x(), image_coordinates.y()));
     }
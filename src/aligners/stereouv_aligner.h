@@ -29,6 +29,16 @@ public:
   //ds set maximum reliable depth for registration
   void setMaximumReliableDepthMeters(const double& maximum_reliable_depth_meters_) {_maximum_reliable_depth_meters = maximum_reliable_depth_meters_;}
 
+//ds helpers
+protected:
+
+  //! @brief linearizes a contiguous block of measurements (thread safe for different blocks)
+  //! @param[in] index_begin_ index of the first measurement
+  //! @param[in] number_of_entries_ number of measurements (at most number_of_measurements_per_chunk)
+  //! @param[in] ignore_outliers_ outliers are not considered in the system if set
+  //! @param[out] chunk_ stacked system and statistics of the block
+  void _linearizeChunk(const Index& index_begin_, const Count& number_of_entries_, const bool& ignore_outliers_, LinearizationChunk& chunk_);
+
 //ds aligner specific
 protected:
 
@@ -40,10 +50,12 @@ protected:
   //ds module paramaters
   real _maximum_reliable_depth_meters = 15;
 
+  //! @brief measurements in structure of arrays layout (one column per measurement): points to align (x, y, z),
+  //! @brief measured image coordinates (u left, v left, u right, v right), isotropic information and translation weights
   Count _number_of_measurements = 0;
-  std::vector<DimensionMatrix, Eigen::aligned_allocator<DimensionMatrix> > _information_vector;
-  std::vector<Vector3, Eigen::aligned_allocator<Vector3> > _moving;
-  std::vector<Vector4, Eigen::aligned_allocator<Vector4> > _fixed;
-  std::vector<real> _weights_translation;
+  Eigen::Matrix<real, 3, Eigen::Dynamic, Eigen::RowMajor> _moving;
+  Eigen::Matrix<real, 4, Eigen::Dynamic, Eigen::RowMajor> _fixed;
+  Eigen::Array<real, 1, Eigen::Dynamic> _information;
+  Eigen::Array<real, 1, Eigen::Dynamic> _weights_translation;
 };
 }
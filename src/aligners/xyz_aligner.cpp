@@ -21,70 +21,66 @@ namespace proslam {
     _inliers.resize(_number_of_measurements);
 
     //ds construct point cloud registration problem - compute landmark coordinates in local maps
-    _information_vector.resize(_number_of_measurements);
-    _moving.resize(_number_of_measurements);
-    _fixed.resize(_number_of_measurements);
+    _information.resize(_number_of_measurements);
+    _moving.resize(3, _number_of_measurements);
+    _fixed.resize(3, _number_of_measurements);
     const TransformMatrix3D& world_to_reference_local_map(context_->local_map_reference->worldToLocalMap());
     const TransformMatrix3D& world_to_query_local_map(context_->local_map_query->worldToLocalMap());
     for (Index u = 0; u < _number_of_measurements; ++u) {
       const Closure::Correspondence* correspondence = _context->correspondences[u];
 
       //ds point coordinates to register
-      _fixed[u]  = world_to_reference_local_map*correspondence->reference->coordinates();
-      _moving[u] = world_to_query_local_map*correspondence->query->coordinates();
+      _fixed.col(u)  = world_to_reference_local_map*correspondence->reference->coordinates();
+      _moving.col(u) = world_to_query_local_map*correspondence->query->coordinates();
 
-      //ds set information matrix
-      _information_vector[u].setIdentity();
-      _information_vector[u] *= correspondence->matching_ratio;
+      //ds set information
+      _information(u) = correspondence->matching_ratio;
     }
   }
 
   void XYZAligner::linearize(const bool& ignore_outliers_) {
+    _number_of_inliers = _linearizeInChunks(_number_of_measurements, _worker_pool,
+                                            [this, &ignore_outliers_](const Index& index_begin_, const Count& number_of_entries_, LinearizationChunk& chunk_) {
+      _linearizeChunk(index_begin_, number_of_entries_, ignore_outliers_, chunk_);
+    }, _total_error, _inliers);
+    _number_of_outliers = _number_of_measurements-_number_of_inliers;
+  }
 
-    //ds initialize setup
-    _H.setZero();
-    _b.setZero();
-    _number_of_inliers  = 0;
-    _number_of_outliers = 0;
-    _total_error        = 0;
-
-    //ds for all the points
-    for (Index u = 0; u < _number_of_measurements; ++u) {
-      _omega = _information_vector[u];
+  void XYZAligner::_linearizeChunk(const Index& index_begin_, const Count& number_of_entries_, const bool& ignore_outliers_, LinearizationChunk& chunk_) {
 
-      //ds compute error based on items: local map merging
-      const PointCoordinates sampled_point_in_reference   = _current_to_reference*_moving[u];
-      const Vector3 error                                 = sampled_point_in_reference-_fixed[u];
+    //ds compute errors based on items for all points of the chunk at once: local map merging
+    ChunkMatrix<3> sampled_points_in_reference(3, number_of_entries_);
+    sampled_points_in_reference.noalias() = _current_to_reference.linear()*_moving.middleCols(index_begin_, number_of_entries_);
+    sampled_points_in_reference.colwise() += _current_to_reference.translation();
+    const ChunkMatrix<3> errors(sampled_points_in_reference-_fixed.middleCols(index_begin_, number_of_entries_));
+    const ChunkArray errors_squared = _information.segment(index_begin_, number_of_entries_)*errors.colwise().squaredNorm().array();
 
-      //ds update chi
-      const real error_squared = error.transpose()*_omega*error;
+    //ds assemble the stacked system
+    for (Index k = 0; k < number_of_entries_; ++k) {
+      const real& error_squared = errors_squared(k);
+      real omega                = _information(index_begin_+k);
 
       //ds check if outlier
       if (error_squared > _parameters->maximum_error_kernel) {
-        _inliers[u] = false;
-        ++_number_of_outliers;
         if (ignore_outliers_) {
           continue;
         }
 
         //ds proportionally reduce information value of the measurement
-        _omega *= _parameters->maximum_error_kernel/error_squared;
+        omega *= _parameters->maximum_error_kernel/error_squared;
       } else {
-        _inliers[u] = true;
-        ++_number_of_inliers;
+        chunk_.is_inlier[k] = 1;
+        ++chunk_.number_of_inliers;
       }
-      _total_error += error_squared;
+      chunk_.total_error += error_squared;
 
       //ds get the jacobian of the transform part = [I -2*skew(T*modelPoint)]
-      _jacobian.block<3,3>(0,0).setIdentity();
-      _jacobian.block<3,3>(0,3) = -2*srrg_core::skew(sampled_point_in_reference);
-
-      //ds precompute transposed
-      const Matrix6_3 jacobian_transposed(_jacobian.transpose( ));
-
-      //ds accumulate
-      _H += jacobian_transposed*_omega*_jacobian;
-      _b += jacobian_transposed*_omega*error;
+      const real weight = std::sqrt(omega);
+      const Index row   = chunk_.number_of_rows;
+      chunk_.jacobians.block<3,3>(row, 0) = weight*Matrix3::Identity();
+      chunk_.jacobians.block<3,3>(row, 3) = -2*weight*srrg_core::skew(Vector3(sampled_points_in_reference.col(k)));
+      chunk_.errors.segment<3>(row)       = weight*errors.col(k);
+      chunk_.number_of_rows += 3;
     }
   }
 
@@ -24,14 +24,24 @@ public:
   //ds solve alignment problem until convergence is reached
   virtual void converge();
 
+//ds helpers
+protected:
+
+  //! @brief linearizes a contiguous block of measurements (thread safe for different blocks)
+  //! @param[in] index_begin_ index of the first measurement
+  //! @param[in] number_of_entries_ number of measurements (at most number_of_measurements_per_chunk)
+  //! @param[in] ignore_outliers_ outliers are not considered in the system if set
+  //! @param[out] chunk_ stacked system and statistics of the block
+  void _linearizeChunk(const Index& index_begin_, const Count& number_of_entries_, const bool& ignore_outliers_, LinearizationChunk& chunk_);
+
 //ds attributes
 protected:
 
-  //ds solver setup (TODO port solver)
+  //ds solver setup: point clouds in structure of arrays layout (one column per measurement) and isotropic information
   Count _number_of_measurements = 0;
-  std::vector<DimensionMatrix, Eigen::aligned_allocator<DimensionMatrix> > _information_vector;
-  std::vector<Vector3> _moving;
-  std::vector<Vector3> _fixed;
+  Eigen::Array<real, 1, Eigen::Dynamic> _information;
+  Eigen::Matrix<real, 3, Eigen::Dynamic, Eigen::RowMajor> _moving;
+  Eigen::Matrix<real, 3, Eigen::Dynamic, Eigen::RowMajor> _fixed;
 
 };
 
@@ -12,7 +12,8 @@ BaseFramePointGenerator::BaseFramePointGenerator(BaseFramePointGeneratorParamete
                                                                                                   _focal_length_pixels(0),
                                                                                                   _principal_point_offset_u_pixels(0),
                                                                                                   _principal_point_offset_v_pixels(0),
-                                                                                                  _number_of_detectors(0) {
+                                                                                                  _number_of_detectors(0),
+                                                                                                  _feature_extractor_left(parameters_) {
   LOG_INFO(std::cerr << "BaseFramePointGenerator::BaseFramePointGenerator|constructed" << std::endl)
 }
 
@@ -28,83 +29,18 @@ void  BaseFramePointGenerator::configure(){
   LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|focal length (pixels): " << _focal_length_pixels << std::endl)
 
   //ds initialize feature matcher
-  _feature_matcher_left.configure(_number_of_rows_image, _number_of_cols_image);
+  _feature_matcher_left.configure(_number_of_rows_image, _number_of_cols_image, _parameters->minimum_projection_tracking_distance_pixels);
+  LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|descriptor distance kernel: " << HammingDistance::kernelName() << std::endl)
 
   //ds configure tracking window
   _projection_tracking_distance_pixels = _parameters->maximum_projection_tracking_distance_pixels;
 
-  //ds allocate descriptor extractor TODO enable further support and check BIT SIZES
-#if CV_MAJOR_VERSION == 2
-  if (_parameters->descriptor_type == "BRIEF-256") {
-    _descriptor_extractor = new cv::BriefDescriptorExtractor(DESCRIPTOR_SIZE_BYTES);
-  } else if (_parameters->descriptor_type == "ORB-256") {
-    _descriptor_extractor        = new cv::OrbDescriptorExtractor();
-    _parameters->descriptor_type = "ORB-256";
-  } else {
-    LOG_WARNING(std::cerr << "BaseFramePointGenerator::configure|descriptor_type: " << _parameters->descriptor_type
-                          << " is not implemented, defaulting to ORB-256" << std::endl)
-    _descriptor_extractor        = new cv::OrbDescriptorExtractor();
-    _parameters->descriptor_type = "ORB-256";
+  //ds allocate worker threads for parallel processing if desired
+  if (_parameters->enable_parallel_keypoint_detection) {
+    _worker_pool = new WorkerPool(_parameters->number_of_worker_threads);
+    LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|parallel processing enabled (threads: "
+                       << _worker_pool->numberOfThreads() << ")" << std::endl)
   }
-#elif CV_MAJOR_VERSION == 3
-  if (_parameters->descriptor_type == "BRIEF-256") {
-    #ifdef SRRG_PROSLAM_HAS_OPENCV_CONTRIB
-      _descriptor_extractor = cv::xfeatures2d::BriefDescriptorExtractor::create(DESCRIPTOR_SIZE_BYTES);
-    #else
-      LOG_WARNING(std::cerr << "BaseFramePointGenerator::configure|descriptor_type: BRIEF-256"
-                            << " is not available in current build, defaulting to ORB-256" << std::endl)
-      _descriptor_extractor        = cv::ORB::create();
-      _parameters->descriptor_type = "ORB-256";
-    #endif
-  } else if (_parameters->descriptor_type == "ORB-256") {
-    _descriptor_extractor = cv::ORB::create();
-  } else if (_parameters->descriptor_type == "BRISK-512") {
-    _descriptor_extractor = cv::BRISK::create();
-  } else if (_parameters->descriptor_type == "FREAK-512") {
-    #ifdef SRRG_PROSLAM_HAS_OPENCV_CONTRIB
-        _descriptor_extractor = cv::xfeatures2d::FREAK::create();
-    #else
-        LOG_WARNING(std::cerr << "BaseFramePointGenerator::configure|descriptor_type: FREAK-512"
-                              << " is not available in current build, defaulting to ORB-256" << std::endl)
-        _descriptor_extractor        = cv::ORB::create();
-        _parameters->descriptor_type = "ORB-256";
-    #endif
-  } else {
-    LOG_WARNING(std::cerr << "BaseFramePointGenerator::configure|descriptor_type: " << _parameters->descriptor_type
-                          << " is not implemented, defaulting to ORB-256" << std::endl)
-    _descriptor_extractor        = cv::ORB::create();
-    _parameters->descriptor_type = "ORB-256";
-  }
-#endif
-
-  //ds log chosen descriptor type and size
-  LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|descriptor_type: " << _parameters->descriptor_type
-                     << " (memory: " << SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS << "b)" << std::endl)
-
-  //ds allocate and initialize detector grid structure
-  _detectors           = new cv::Ptr<cv::FastFeatureDetector>*[_parameters->number_of_detectors_vertical];
-  _detector_regions    = new cv::Rect*[_parameters->number_of_detectors_vertical];
-  _detector_thresholds = new real*[_parameters->number_of_detectors_vertical];
-  const real pixel_rows_per_detector = static_cast<real>(_number_of_rows_image)/_parameters->number_of_detectors_vertical;
-  const real pixel_cols_per_detector = static_cast<real>(_number_of_cols_image)/_parameters->number_of_detectors_horizontal;
-  for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
-    _detectors[r]           = new cv::Ptr<cv::FastFeatureDetector>[_parameters->number_of_detectors_horizontal];
-    _detector_regions[r]    = new cv::Rect[_parameters->number_of_detectors_horizontal];
-    _detector_thresholds[r] = new real[_parameters->number_of_detectors_horizontal];
-    for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
-#if CV_MAJOR_VERSION == 2
-      _detectors[r][c] = new cv::FastFeatureDetector(_parameters->detector_threshold_minimum);
-#else
-      _detectors[r][c] = cv::FastFeatureDetector::create(_parameters->detector_threshold_minimum);
-#endif
-      _detector_regions[r][c] = cv::Rect(std::round(c*pixel_cols_per_detector),
-                                         std::round(r*pixel_rows_per_detector),
-                                         pixel_cols_per_detector,
-                                         pixel_rows_per_detector);
-      _detector_thresholds[r][c] = _parameters->detector_threshold_minimum;
-    }
-  }
-  _number_of_detectors = _parameters->number_of_detectors_vertical*_parameters->number_of_detectors_horizontal;
 
   //ds compute binning configuration
   _number_of_cols_bin = std::floor(static_cast<real>(_camera_left->numberOfImageCols())/_parameters->bin_size_pixels)+1;
@@ -115,17 +51,27 @@ void  BaseFramePointGenerator::configure(){
   LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|current target number of points: " << _target_number_of_keypoints << std::endl)
 
   //ds compute target points per detector region
+  _number_of_detectors = _parameters->number_of_detectors_vertical*_parameters->number_of_detectors_horizontal;
   _target_number_of_keypoints_per_detector = static_cast<real>(_target_number_of_keypoints)/_number_of_detectors;
   LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|current target number of points per image region: " << _target_number_of_keypoints_per_detector << std::endl)
 
-  //ds allocate and initialize bin grid
-  _bin_map_left = new FramePoint**[_number_of_rows_bin];
-  for (Index row = 0; row < _number_of_rows_bin; ++row) {
-    _bin_map_left[row] = new FramePoint*[_number_of_cols_bin];
-    for (Index col = 0; col < _number_of_cols_bin; ++col) {
-      _bin_map_left[row][col] = nullptr;
+  //ds allocate detectors and descriptor extractor for the left image stream
+  _feature_extractor_left.configure(_number_of_rows_image,
+                                    _number_of_cols_image,
+                                    _target_number_of_keypoints_per_detector,
+                                    _parameters->enable_parallel_keypoint_detection? _worker_pool: nullptr);
+
+  //ds check pyramid configuration
+  if (_parameters->enable_pyramid_tracking) {
+    if (_parameters->number_of_pyramid_levels < 2 || _parameters->pyramid_search_radius_pixels < 1) {
+      throw std::runtime_error("BaseFramePointGenerator::configure|invalid pyramid tracking configuration");
     }
+    LOG_INFO(std::cerr << "BaseFramePointGenerator::configure|pyramid tracking enabled (levels: " << _parameters->number_of_pyramid_levels
+                       << " search radius: " << _parameters->pyramid_search_radius_pixels << ")" << std::endl)
   }
+
+  //ds allocate bin grid
+  _bin_map_left.resize(_number_of_rows_bin*_number_of_cols_bin);
   LOG_INFO(std::cerr << "BaseTracker::configure|number of horizontal bins: " << _number_of_cols_bin << " size: " << _parameters->bin_size_pixels << std::endl)
   LOG_INFO(std::cerr << "BaseTracker::configure|number of vertical bins: " << _number_of_rows_bin << " size: " << _parameters->bin_size_pixels << std::endl)
 
@@ -137,98 +83,31 @@ void  BaseFramePointGenerator::configure(){
 BaseFramePointGenerator::~BaseFramePointGenerator() {
   LOG_INFO(std::cerr << "BaseFramePointGenerator::~BaseFramePointGenerator|destroying" << std::endl)
 
-  //ds deallocate dynamic data structures: detectors
-  if (_detectors && _detector_regions && _detector_thresholds) {
-    for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
-      delete[] _detectors[r];
-      delete[] _detector_regions[r];
-      delete[] _detector_thresholds[r];
-    }
-    delete [] _detectors;
-    delete [] _detector_regions;
-    delete [] _detector_thresholds;
-  }
-
-  //ds free bin map
-  for (Count row = 0; row < _number_of_rows_bin; ++row) {
-    delete[] _bin_map_left[row];
-  }
-  delete[] _bin_map_left;
+  //ds stop worker threads
+  delete _worker_pool;
   LOG_INFO(std::cerr << "BaseFramePointGenerator::~BaseFramePointGenerator|destroyed" << std::endl)
 }
 
 void BaseFramePointGenerator::detectKeypoints(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_) {
   CHRONOMETER_START(keypoint_detection)
-
-  //ds detect new keypoints in each image region
-  for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
-    for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
-
-      //ds detect keypoints in current region
-      std::vector<cv::KeyPoint> keypoints_per_detector(0);
-      _detectors[r][c]->detect(intensity_image_(_detector_regions[r][c]), keypoints_per_detector);
-
-      //ds current threshold for this detector
-#if CV_MAJOR_VERSION == 2
-      real detector_threshold = _detectors[r][c]->getInt("threshold");
-#else
-      real detector_threshold = _detectors[r][c]->getThreshold();
-#endif
-
-      //ds compute point delta: 100% loss > -1, 100% gain > +1
-      const real delta = (static_cast<real>(keypoints_per_detector.size())-_target_number_of_keypoints_per_detector)/_target_number_of_keypoints_per_detector;
-
-      //ds check if there's a significant loss of target points (delta is negative)
-      if (delta < -_parameters->target_number_of_keypoints_tolerance) { // Keypoint가 부족한 경우 Threshold 줄임
-
-        //ds compute new, lower threshold, capped and damped
-        const real change = std::max(delta, -_parameters->detector_threshold_maximum_change);
-
-        //ds always lower threshold by at least 1
-        detector_threshold += std::min(change*detector_threshold, -1.0);
-
-        //ds check minimum threshold
-        if (detector_threshold < _parameters->detector_threshold_minimum) {
-          detector_threshold = _parameters->detector_threshold_minimum;
-        }
-      }
-
-      //ds or if there's a significant gain of target points (delta is positive)
-      else if (delta > _parameters->target_number_of_keypoints_tolerance) { // Keypoint가 넘치는 경우, Threshold 늘림
-
-        //ds compute new, higher threshold - capped and damped
-        const real change = std::min(delta, _parameters->detector_threshold_maximum_change);
-
-        //ds always increase threshold by at least 1
-        detector_threshold += std::max(change*detector_threshold, 1.0);
-
-        //ds check maximum threshold
-        if (detector_threshold > _parameters->detector_threshold_maximum) {
-          detector_threshold = _parameters->detector_threshold_maximum;
-        }
-      }
-
-      //ds set threshold (no effect if not changed)
-      _detector_thresholds[r][c] = detector_threshold;
-
-      //ds shift keypoint coordinates to whole image region
-      const cv::Point2f& offset = _detector_regions[r][c].tl(); // 사각형 영역의 Top-Left 포인트
-      std::for_each(keypoints_per_detector.begin(), keypoints_per_detector.end(), [&offset](cv::KeyPoint& keypoint_) {keypoint_.pt += offset;}); // Grid 좌표계에서 전체 이미지 전체 좌표계로 변경
-
-      //ds add to complete vector
-      keypoints_.insert(keypoints_.end(), keypoints_per_detector.begin(), keypoints_per_detector.end());
-    }
-  }
+  _feature_extractor_left.detectKeypoints(intensity_image_, keypoints_);
   _number_of_detected_keypoints = keypoints_.size();
   CHRONOMETER_STOP(keypoint_detection)
 }
 
 void BaseFramePointGenerator::computeDescriptors(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_) {
   CHRONOMETER_START(descriptor_extraction)
-  _descriptor_extractor->compute(intensity_image_, keypoints_, descriptors_);
+  _feature_extractor_left.computeDescriptors(intensity_image_, keypoints_, descriptors_);
   CHRONOMETER_STOP(descriptor_extraction)
 }
 
+void BaseFramePointGenerator::describeKeypoints(const cv::Mat& intensity_image_,
+                                                std::vector<cv::KeyPoint>& keypoints_,
+                                                DescriptorVector& descriptors_,
+                                                std::vector<uint8_t>& is_described_) {
+  _feature_extractor_left.describeKeypoints(intensity_image_, keypoints_, descriptors_, is_described_);
+}
+
 void BaseFramePointGenerator::track(Frame* frame_,
                                     Frame* frame_previous_,
                                     const TransformMatrix3D& camera_left_previous_in_current_,
@@ -238,14 +117,82 @@ void BaseFramePointGenerator::track(Frame* frame_,
 }
 
 void BaseFramePointGenerator::adjustDetectorThresholds() {
-  for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
-    for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
-#if CV_MAJOR_VERSION == 2
-      _detectors[r][c]->setInt("threshold", _detector_thresholds[r][c]);
-#else
-      _detectors[r][c]->setThreshold(_detector_thresholds[r][c]);
-#endif
+  _feature_extractor_left.adjustDetectorThresholds();
+}
+
+void BaseFramePointGenerator::_updateImagePyramid(const Frame* frame_) {
+
+  //ds keep the current pyramid as previous one (swapping keeps the image allocations)
+  std::swap(_image_pyramid_current, _image_pyramid_previous);
+  _image_pyramid_identifier_previous = _image_pyramid_identifier_current;
+  _is_image_pyramid_previous_valid   = _is_image_pyramid_current_valid;
+
+  //ds build the new pyramid (level 0 references the frame image)
+  cv::buildPyramid(frame_->intensityImageLeft(), _image_pyramid_current, _parameters->number_of_pyramid_levels-1);
+  _image_pyramid_identifier_current = frame_->identifier();
+  _is_image_pyramid_current_valid   = true;
+}
+
+bool BaseFramePointGenerator::_isImagePyramidAvailable(const Frame* frame_previous_, const Frame* frame_) const {
+  return (_is_image_pyramid_previous_valid && _image_pyramid_identifier_previous == frame_previous_->identifier() &&
+          _is_image_pyramid_current_valid  && _image_pyramid_identifier_current  == frame_->identifier());
+}
+
+bool BaseFramePointGenerator::_refinePredictionInPyramid(const cv::Point2f& position_previous_, cv::Point2f& position_predicted_) const {
+  constexpr int32_t half_patch_size = _pyramid_patch_size_pixels/2;
+  const int32_t search_radius       = _parameters->pyramid_search_radius_pixels;
+  cv::Point2f position_predicted(position_predicted_);
+
+  //ds from the coarsest level to the second finest
+  for (int32_t level = _image_pyramid_current.size()-1; level > 0; --level) {
+    const cv::Mat& image_previous = _image_pyramid_previous[level];
+    const cv::Mat& image_current  = _image_pyramid_current[level];
+    const real scale              = 1 << level;
+
+    //ds patch in the previous image and search region in the current image must be completely inside the images
+    const int32_t row_previous = std::round(position_previous_.y/scale);
+    const int32_t col_previous = std::round(position_previous_.x/scale);
+    const int32_t row_center   = std::round(position_predicted.y/scale);
+    const int32_t col_center   = std::round(position_predicted.x/scale);
+    if (row_previous-half_patch_size < 0 || row_previous+half_patch_size > image_previous.rows ||
+        col_previous-half_patch_size < 0 || col_previous+half_patch_size > image_previous.cols ||
+        row_center-search_radius-half_patch_size < 0 || row_center+search_radius+half_patch_size > image_current.rows ||
+        col_center-search_radius-half_patch_size < 0 || col_center+search_radius+half_patch_size > image_current.cols) {
+      return false;
+    }
+
+    //ds exhaustive search for the patch offset with minimum sum of absolute differences (ties: first in row major order)
+    uint32_t difference_best = std::numeric_limits<uint32_t>::max();
+    int32_t row_offset_best  = 0;
+    int32_t col_offset_best  = 0;
+    for (int32_t row_offset = -search_radius; row_offset <= search_radius; ++row_offset) {
+      for (int32_t col_offset = -search_radius; col_offset <= search_radius; ++col_offset) {
+        uint32_t difference = 0;
+        for (int32_t r = -half_patch_size; r < half_patch_size; ++r) {
+          const uint8_t* row_patch_previous = image_previous.ptr<uint8_t>(row_previous+r)+col_previous-half_patch_size;
+          const uint8_t* row_patch_current  = image_current.ptr<uint8_t>(row_center+row_offset+r)+col_center+col_offset-half_patch_size;
+          for (int32_t c = 0; c < _pyramid_patch_size_pixels; ++c) {
+            difference += std::abs(static_cast<int32_t>(row_patch_previous[c])-static_cast<int32_t>(row_patch_current[c]));
+          }
+        }
+        if (difference < difference_best) {
+          difference_best = difference;
+          row_offset_best = row_offset;
+          col_offset_best = col_offset;
+        }
+      }
     }
+
+    //ds reject the alignment if the best patch does not resemble the previous one (e.g. occlusion)
+    if (difference_best > _maximum_mean_pyramid_patch_difference*_pyramid_patch_size_pixels*_pyramid_patch_size_pixels) {
+      return false;
+    }
+
+    //ds move the prediction to the aligned position
+    position_predicted.x += col_offset_best*scale;
+    position_predicted.y += row_offset_best*scale;
   }
+  position_predicted_ = position_predicted;
+  return true;
 }
 }
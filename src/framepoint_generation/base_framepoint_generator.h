@@ -1,5 +1,6 @@
 #pragma once
 #include "types/frame.h"
+#include "intensity_feature_extractor.h"
 #include "intensity_feature_matcher.h"
 
 
@@ -27,6 +28,16 @@ public:
   //ds extracts the defined descriptors for the given keypoints (called within compute)
   void computeDescriptors(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_);
 
+  //! @brief computes descriptors for arbitrary keypoints in the current left image with a single extraction (e.g. for point recovery)
+  //! @param[in] intensity_image_ left image of the last initialized frame
+  //! @param[in,out] keypoints_ keypoints to describe
+  //! @param[out] descriptors_ descriptor for each keypoint (only valid if described)
+  //! @param[out] is_described_ for each keypoint: 1 if a descriptor could be computed, 0 otherwise
+  void describeKeypoints(const cv::Mat& intensity_image_,
+                         std::vector<cv::KeyPoint>& keypoints_,
+                         DescriptorVector& descriptors_,
+                         std::vector<uint8_t>& is_described_);
+
   //@ brief computes tracks between current and previous image points based on appearance
   //! @param[out] previous_points_without_tracks_ lost points
   virtual void track(Frame* frame_,
@@ -36,13 +47,13 @@ public:
                      const bool track_by_appearance_ = true);
 
   //ds adjust detector thresholds (for all image streams)
-  void adjustDetectorThresholds();
+  virtual void adjustDetectorThresholds();
 
 //ds getters/setters
 public:
 
   //ds enable external access to descriptor extractor
-  cv::Ptr<cv::DescriptorExtractor> descriptorExtractor() const {return _descriptor_extractor;}
+  cv::Ptr<cv::DescriptorExtractor> descriptorExtractor() const {return _feature_extractor_left.descriptorExtractor();}
 
   //ds other properties
   void setCameraLeft(const Camera* camera_left_) {_camera_left = camera_left_;}
@@ -55,6 +66,24 @@ public:
   const Count& numberOfDetectedKeypoints() const {return _number_of_detected_keypoints;}
   const Count& numberOfTrackedLandmarks() const {return _number_of_tracked_landmarks;}
   const Count& numberOfAvailablePoints() const {return _number_of_available_points;}
+  WorkerPool* workerPool() const {return _worker_pool;}
+
+//ds helpers
+protected:
+
+  //! @brief builds the left image pyramid of a frame, the pyramid of the preceding call is kept as previous pyramid
+  //! @param[in] frame_ frame with left intensity image
+  void _updateImagePyramid(const Frame* frame_);
+
+  //! @brief checks whether the image pyramids of both frames are available
+  bool _isImagePyramidAvailable(const Frame* frame_previous_, const Frame* frame_) const;
+
+  //! @brief refines the predicted image position of a point by patch alignment from the coarsest to the second finest pyramid level
+  //! @brief the final search at full resolution is left to the descriptor matching (thread safe)
+  //! @param[in] position_previous_ position of the point in the previous left image
+  //! @param[in,out] position_predicted_ predicted position in the current left image (refined on success)
+  //! @return true if the alignment succeeded on all levels
+  bool _refinePredictionInPyramid(const cv::Point2f& position_previous_, cv::Point2f& position_predicted_) const;
 
 //ds settings
 protected:
@@ -76,30 +105,39 @@ protected:
   real _principal_point_offset_u_pixels;
   real _principal_point_offset_v_pixels;
 
-  //! @brief grid of detectors (equally distributed over the image with size=number_of_detectors_per_dimension*number_of_detectors_per_dimension)
-  cv::Ptr<cv::FastFeatureDetector>** _detectors = nullptr;
-  real** _detector_thresholds                   = nullptr;
-
   //! @brief number of detectors
   //! @brief the same for all image streams
   uint32_t _number_of_detectors;
 
-  //! @brief image region for each detector
-  //! @brief the same for all image streams
-  cv::Rect** _detector_regions = nullptr;
+  //! @brief keypoint detection and descriptor extraction for the left image stream (detector thresholds adapt per stream)
+  IntensityFeatureExtractor _feature_extractor_left;
 
-  //ds descriptor extraction
-  cv::Ptr<cv::DescriptorExtractor> _descriptor_extractor;
+  //! @brief worker threads for parallel processing (only allocated if enabled)
+  WorkerPool* _worker_pool = nullptr;
 
   //ds feature density regularization
-  Count _number_of_rows_bin      = 0;
-  Count _number_of_cols_bin      = 0;
-  FramePointMatrix _bin_map_left = nullptr;
+  Count _number_of_rows_bin = 0;
+  Count _number_of_cols_bin = 0;
+
+  //! @brief bin occupancy in the left image (row major, the content is defined by the generator)
+  std::vector<int32_t> _bin_map_left;
 
   //! @brief feature matching class (maintains features in a 2D lattice corresponding to the image and a vector)
   IntensityFeatureMatcher _feature_matcher_left;
   std::vector<IntensityFeature> _keypoints_with_descriptors_left;
 
+  //! @brief left image pyramids (level 0 is the full resolution image) of the current and the previous frame
+  std::vector<cv::Mat> _image_pyramid_current;
+  std::vector<cv::Mat> _image_pyramid_previous;
+  Identifier _image_pyramid_identifier_current  = 0;
+  Identifier _image_pyramid_identifier_previous = 0;
+  bool _is_image_pyramid_current_valid  = false;
+  bool _is_image_pyramid_previous_valid = false;
+
+  //! @brief pyramid alignment: patch size (square, even) and maximum mean absolute intensity difference of an aligned patch
+  static constexpr int32_t _pyramid_patch_size_pixels            = 8;
+  static constexpr uint32_t _maximum_mean_pyramid_patch_difference = 32;
+
   //! @brief currently active projection tracking distance (adjusted dynamically at runtime)
   int32_t _projection_tracking_distance_pixels = 10;
 
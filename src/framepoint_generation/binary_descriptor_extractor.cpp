@@ -0,0 +1,141 @@
+#include "binary_descriptor_extractor.h"
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
+
+
+namespace proslam {
+
+BinaryDescriptorExtractor::BinaryDescriptorExtractor() {
+
+  //ds precompute the sampling pattern: isotropic gaussian around the keypoint (BRIEF G II, sigma^2 = S^2/25)
+  //ds we use our own generator to obtain the identical pattern on every platform and standard library
+  const real sigma = (2*_patch_radius+1)/5.0;
+  uint64_t state   = 0x9E3779B97F4A7C15;
+  auto sampleUniform = [&state]() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return (static_cast<real>(state >> 11)+0.5)/static_cast<real>(uint64_t(1) << 53);
+  };
+  auto sampleCoordinate = [&]() {
+    while (true) {
+
+      //ds Box-Muller transform, samples outside of the patch are rejected
+      const int32_t coordinate = std::round(sigma*std::sqrt(-2*std::log(sampleUniform()))*std::cos(2*M_PI*sampleUniform()));
+      if (std::abs(coordinate) <= _patch_radius) {
+        return coordinate;
+      }
+    }
+  };
+  for (int32_t u = 0; u < _number_of_pairs; ++u) {
+    do {
+      _pattern_a[u] = cv::Point(sampleCoordinate(), sampleCoordinate());
+      _pattern_b[u] = cv::Point(sampleCoordinate(), sampleCoordinate());
+    } while (_pattern_a[u].x == _pattern_b[u].x && _pattern_a[u].y == _pattern_b[u].y);
+    _offsets_a[u] = 0;
+    _offsets_b[u] = 0;
+  }
+  LOG_INFO(std::cerr << "BinaryDescriptorExtractor::BinaryDescriptorExtractor|constructed (pairs: " << _number_of_pairs << ")" << std::endl)
+}
+
+#if CV_MAJOR_VERSION == 2
+void BinaryDescriptorExtractor::computeImpl(const cv::Mat& image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_) const {
+
+  //ds the OpenCV 2 interface is const, the smoothed image is our only state
+  BinaryDescriptorExtractor* extractor = const_cast<BinaryDescriptorExtractor*>(this);
+  extractor->setImage(image_);
+  _filterKeypoints(keypoints_);
+  descriptors_.create(keypoints_.size(), DESCRIPTOR_SIZE_BYTES, CV_8U);
+  computeDescriptors(keypoints_, descriptors_.ptr<uint8_t>(0));
+}
+#else
+void BinaryDescriptorExtractor::compute(cv::InputArray image_, std::vector<cv::KeyPoint>& keypoints_, cv::OutputArray descriptors_) {
+  setImage(image_.getMat());
+  _filterKeypoints(keypoints_);
+  descriptors_.create(keypoints_.size(), DESCRIPTOR_SIZE_BYTES, CV_8U);
+  cv::Mat descriptors(descriptors_.getMat());
+  computeDescriptors(keypoints_, descriptors.ptr<uint8_t>(0));
+}
+#endif
+
+void BinaryDescriptorExtractor::setImage(const cv::Mat& intensity_image_) {
+
+  //ds single level smoothing (same kernel as ORB)
+  cv::GaussianBlur(intensity_image_, _image_smoothed, cv::Size(7, 7), 2, 2, cv::BORDER_REFLECT_101);
+
+  //ds update memory offsets of the sampling pattern if the image layout changed
+  if (_image_smoothed.step != _image_step) {
+    _image_step = _image_smoothed.step;
+    for (int32_t u = 0; u < _number_of_pairs; ++u) {
+      _offsets_a[u] = _pattern_a[u].y*static_cast<int32_t>(_image_step)+_pattern_a[u].x;
+      _offsets_b[u] = _pattern_b[u].y*static_cast<int32_t>(_image_step)+_pattern_b[u].x;
+    }
+  }
+}
+
+const bool BinaryDescriptorExtractor::isDescribable(const cv::KeyPoint& keypoint_) const {
+  const int32_t row = std::round(keypoint_.pt.y);
+  const int32_t col = std::round(keypoint_.pt.x);
+  return (row >= _patch_radius && row < _image_smoothed.rows-_patch_radius &&
+          col >= _patch_radius && col < _image_smoothed.cols-_patch_radius);
+}
+
+void BinaryDescriptorExtractor::computeDescriptor(const cv::KeyPoint& keypoint_, uint8_t* descriptor_) const {
+  assert(isDescribable(keypoint_));
+  const uint8_t* center = _image_smoothed.ptr<uint8_t>(std::round(keypoint_.pt.y))+static_cast<int32_t>(std::round(keypoint_.pt.x));
+
+  //ds gather the sampled intensities into contiguous buffers
+  alignas(32) uint8_t intensities_a[_number_of_pairs];
+  alignas(32) uint8_t intensities_b[_number_of_pairs];
+  for (int32_t u = 0; u < _number_of_pairs; ++u) {
+    intensities_a[u] = center[_offsets_a[u]];
+    intensities_b[u] = center[_offsets_b[u]];
+  }
+
+  //ds compare all pairs: bit u is set if intensity a < intensity b (OpenCV bit order)
+  alignas(32) uint8_t bits[_number_of_pairs/8];
+#if defined(__AVX2__)
+  for (int32_t u = 0; u < _number_of_pairs; u += 32) {
+    const __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(intensities_a+u));
+    const __m256i b = _mm256_load_si256(reinterpret_cast<const __m256i*>(intensities_b+u));
+
+    //ds a >= b if min(a, b) == b (unsigned comparison)
+    const uint32_t mask_greater_equal = _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(a, b), b));
+    const uint32_t mask_less          = ~mask_greater_equal;
+    std::memcpy(bits+u/8, &mask_less, 4);
+  }
+#elif defined(__SSE2__)
+  for (int32_t u = 0; u < _number_of_pairs; u += 16) {
+    const __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(intensities_a+u));
+    const __m128i b = _mm_load_si128(reinterpret_cast<const __m128i*>(intensities_b+u));
+    const uint16_t mask_less = ~static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(a, b), b)));
+    std::memcpy(bits+u/8, &mask_less, 2);
+  }
+#else
+  for (int32_t u = 0; u < _number_of_pairs; u += 8) {
+    uint8_t value = 0;
+    for (int32_t v = 0; v < 8; ++v) {
+      value |= (intensities_a[u+v] < intensities_b[u+v]) << v;
+    }
+    bits[u/8] = value;
+  }
+#endif
+  std::memcpy(descriptor_, bits, DESCRIPTOR_SIZE_BYTES);
+}
+
+void BinaryDescriptorExtractor::computeDescriptors(const std::vector<cv::KeyPoint>& keypoints_, uint8_t* descriptors_) const {
+  for (const cv::KeyPoint& keypoint: keypoints_) {
+    computeDescriptor(keypoint, descriptors_);
+    descriptors_ += DESCRIPTOR_SIZE_BYTES;
+  }
+}
+
+void BinaryDescriptorExtractor::_filterKeypoints(std::vector<cv::KeyPoint>& keypoints_) const {
+  keypoints_.erase(std::remove_if(keypoints_.begin(), keypoints_.end(),
+                                  [this](const cv::KeyPoint& keypoint_){return !isDescribable(keypoint_);}), keypoints_.end());
+}
+} //namespace proslam
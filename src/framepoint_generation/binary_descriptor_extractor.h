@@ -0,0 +1,96 @@
+#pragma once
+#include "types/definitions.h"
+
+
+
+namespace proslam {
+
+//! @class native binary descriptor extractor (BRIEF-like) operating on a single image level
+//! intensity pairs are sampled from a fixed, precomputed pattern around the keypoint in a gaussian smoothed image
+//! no image pyramid and no orientation is computed (all our keypoints are detected on the full resolution image)
+//! the extractor implements the OpenCV descriptor extractor interface and additionally provides a raw interface
+//! that writes descriptors directly into a caller provided buffer
+class BinaryDescriptorExtractor: public cv::DescriptorExtractor {
+
+//ds object handling
+public:
+
+  //! @brief constructs the extractor and precomputes the sampling pattern
+  BinaryDescriptorExtractor();
+
+  //! @brief default destructor
+  ~BinaryDescriptorExtractor() {}
+
+//ds OpenCV interface
+public:
+
+#if CV_MAJOR_VERSION == 2
+  virtual int descriptorSize() const {return DESCRIPTOR_SIZE_BYTES;}
+  virtual int descriptorType() const {return CV_8U;}
+#else
+  using cv::DescriptorExtractor::compute;
+
+  //! @brief computes descriptors for all keypoints (keypoints too close to the image border are removed)
+  //! @param[in] image_ intensity image (CV_8UC1)
+  //! @param[in,out] keypoints_ keypoints to describe
+  //! @param[out] descriptors_ descriptor matrix with one row per remaining keypoint (CV_8U)
+  virtual void compute(cv::InputArray image_, std::vector<cv::KeyPoint>& keypoints_, cv::OutputArray descriptors_) override;
+  virtual int descriptorSize() const override {return DESCRIPTOR_SIZE_BYTES;}
+  virtual int descriptorType() const override {return CV_8U;}
+  virtual int defaultNorm() const override {return SRRG_PROSLAM_DESCRIPTOR_NORM;}
+#endif
+
+//ds functionality
+public:
+
+  //! @brief sets the image to extract descriptors from (smooths the image once, must be called before computeDescriptor)
+  //! @param[in] intensity_image_ intensity image (CV_8UC1)
+  void setImage(const cv::Mat& intensity_image_);
+
+  //! @brief checks whether the complete sampling pattern of a keypoint lies within the current image
+  //! @param[in] keypoint_ keypoint to check
+  //! @return true if the keypoint can be described, false otherwise
+  const bool isDescribable(const cv::KeyPoint& keypoint_) const;
+
+  //! @brief computes the descriptor of a single (describable) keypoint in the current image
+  //! @param[in] keypoint_ keypoint to describe
+  //! @param[out] descriptor_ caller provided buffer of DESCRIPTOR_SIZE_BYTES bytes
+  void computeDescriptor(const cv::KeyPoint& keypoint_, uint8_t* descriptor_) const;
+
+  //! @brief computes descriptors of (describable) keypoints in the current image into a contiguous buffer
+  //! @param[in] keypoints_ keypoints to describe
+  //! @param[out] descriptors_ caller provided buffer of keypoints_.size()*DESCRIPTOR_SIZE_BYTES bytes
+  void computeDescriptors(const std::vector<cv::KeyPoint>& keypoints_, uint8_t* descriptors_) const;
+
+//ds helpers
+protected:
+
+#if CV_MAJOR_VERSION == 2
+  virtual void computeImpl(const cv::Mat& image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_) const;
+#endif
+
+  //! @brief removes all keypoints that cannot be described in the current image
+  void _filterKeypoints(std::vector<cv::KeyPoint>& keypoints_) const;
+
+//ds attributes
+protected:
+
+  //! @brief sampling patch radius in pixels
+  static constexpr int32_t _patch_radius = 15;
+
+  //! @brief number of sampled intensity pairs (padded to a multiple of the widest comparison register)
+  static constexpr int32_t _number_of_pairs = ((SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS+31)/32)*32;
+
+  //! @brief sampling pattern as pixel coordinate offsets with respect to the keypoint
+  cv::Point _pattern_a[_number_of_pairs];
+  cv::Point _pattern_b[_number_of_pairs];
+
+  //! @brief sampling pattern as memory offsets for the current image (updated if the row step changes)
+  int32_t _offsets_a[_number_of_pairs];
+  int32_t _offsets_b[_number_of_pairs];
+  size_t _image_step = 0;
+
+  //! @brief smoothed image of the current call
+  cv::Mat _image_smoothed;
+};
+} //namespace proslam
@@ -107,8 +107,14 @@ void DepthFramePointGenerator::compute(Frame* frame_) {
   _computeDepthMap(frame_->intensityImageRight());
   CHRONOMETER_STOP(depth_map_generation)
 
-  //ds extract descriptors for detected features
-  computeDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft(), frame_->descriptorsLeft());
+  //ds extract descriptors for detected features (in lazy mode only for keypoints with valid depth, see computeCoordinatesFromDepth)
+  if (_feature_extractor_left.isLazy()) {
+    CHRONOMETER_START(descriptor_extraction)
+    _feature_extractor_left.prepareLazyDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft());
+    CHRONOMETER_STOP(descriptor_extraction)
+  } else {
+    computeDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft(), frame_->descriptorsLeft());
+  }
 
   //ds prepare and execute stereo keypoint search
   CHRONOMETER_START(depth_assignment)
@@ -123,12 +129,13 @@ void DepthFramePointGenerator::computeCoordinatesFromDepth(Frame* frame_, std::v
 
   for (size_t i=0; i<keypoints_.size(); i++) {
     const cv::KeyPoint & keypoint_left=keypoints_[i];
-    const cv::Mat& descriptor_left=descriptors_.row(i);
     const Index r_left=keypoint_left.pt.y;
     const Index c_left=keypoint_left.pt.x;
     const cv::Vec3f& p=_space_map_left_meters.at<const cv::Vec3f>(r_left, c_left);
     if (p[2]>=_maximum_reliable_depth_far_meters)
       continue;
+    const Descriptor descriptor_left=(_feature_extractor_left.isLazy()? _feature_extractor_left.describe(keypoint_left)
+                                                                       : Descriptor::fromMat(descriptors_, i));
 
 
     cv::KeyPoint keypoint_right=keypoint_left;
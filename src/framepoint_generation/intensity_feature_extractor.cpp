@@ -0,0 +1,370 @@
+#include "intensity_feature_extractor.h"
+
+
+
+namespace proslam {
+
+IntensityFeatureExtractor::IntensityFeatureExtractor(BaseFramePointGeneratorParameters* parameters_): _parameters(parameters_) {
+  LOG_INFO(std::cerr << "IntensityFeatureExtractor::IntensityFeatureExtractor|constructed" << std::endl)
+}
+
+IntensityFeatureExtractor::~IntensityFeatureExtractor() {
+  LOG_INFO(std::cerr << "IntensityFeatureExtractor::~IntensityFeatureExtractor|destroying" << std::endl)
+
+  //ds deallocate dynamic data structures: detectors
+  if (_detectors && _detector_regions && _detector_thresholds && _keypoints_per_detector) {
+    for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
+      delete[] _detectors[r];
+      delete[] _detector_regions[r];
+      delete[] _detector_thresholds[r];
+      delete[] _keypoints_per_detector[r];
+    }
+    delete [] _detectors;
+    delete [] _detector_regions;
+    delete [] _detector_thresholds;
+    delete [] _keypoints_per_detector;
+  }
+  LOG_INFO(std::cerr << "IntensityFeatureExtractor::~IntensityFeatureExtractor|destroyed" << std::endl)
+}
+
+void IntensityFeatureExtractor::configure(const int32_t& rows_,
+                                          const int32_t& cols_,
+                                          const real& target_number_of_keypoints_per_detector_,
+                                          WorkerPool* worker_pool_) {
+  LOG_INFO(std::cerr << "IntensityFeatureExtractor::configure|configuring" << std::endl)
+  if (rows_ <= 0 || cols_ <= 0) {
+    throw std::runtime_error("IntensityFeatureExtractor::configure|invalid image dimensions");
+  }
+  if (_detectors) {
+    throw std::runtime_error("IntensityFeatureExtractor::configure|detectors already allocated");
+  }
+  _target_number_of_keypoints_per_detector = target_number_of_keypoints_per_detector_;
+  _worker_pool                             = worker_pool_;
+
+  //ds allocate descriptor extractor TODO enable further support and check BIT SIZES
+#if CV_MAJOR_VERSION == 2
+  if (_parameters->descriptor_type == "BRIEF-256-NATIVE") {
+    _descriptor_extractor = new BinaryDescriptorExtractor();
+  } else if (_parameters->descriptor_type == "BRIEF-256") {
+    _descriptor_extractor = new cv::BriefDescriptorExtractor(DESCRIPTOR_SIZE_BYTES);
+  } else if (_parameters->descriptor_type == "ORB-256") {
+    _descriptor_extractor        = new cv::OrbDescriptorExtractor();
+    _parameters->descriptor_type = "ORB-256";
+  } else {
+    LOG_WARNING(std::cerr << "IntensityFeatureExtractor::configure|descriptor_type: " << _parameters->descriptor_type
+                          << " is not implemented, defaulting to ORB-256" << std::endl)
+    _descriptor_extractor        = new cv::OrbDescriptorExtractor();
+    _parameters->descriptor_type = "ORB-256";
+  }
+#elif CV_MAJOR_VERSION == 3
+  if (_parameters->descriptor_type == "BRIEF-256-NATIVE") {
+    _descriptor_extractor = cv::makePtr<BinaryDescriptorExtractor>();
+  } else if (_parameters->descriptor_type == "BRIEF-256") {
+    #ifdef SRRG_PROSLAM_HAS_OPENCV_CONTRIB
+      _descriptor_extractor = cv::xfeatures2d::BriefDescriptorExtractor::create(DESCRIPTOR_SIZE_BYTES);
+    #else
+      LOG_WARNING(std::cerr << "IntensityFeatureExtractor::configure|descriptor_type: BRIEF-256"
+                            << " is not available in current build, defaulting to ORB-256" << std::endl)
+      _descriptor_extractor        = cv::ORB::create();
+      _parameters->descriptor_type = "ORB-256";
+    #endif
+  } else if (_parameters->descriptor_type == "ORB-256") {
+    _descriptor_extractor = cv::ORB::create();
+  } else if (_parameters->descriptor_type == "BRISK-512") {
+    _descriptor_extractor = cv::BRISK::create();
+  } else if (_parameters->descriptor_type == "FREAK-512") {
+    #ifdef SRRG_PROSLAM_HAS_OPENCV_CONTRIB
+        _descriptor_extractor = cv::xfeatures2d::FREAK::create();
+    #else
+        LOG_WARNING(std::cerr << "IntensityFeatureExtractor::configure|descriptor_type: FREAK-512"
+                              << " is not available in current build, defaulting to ORB-256" << std::endl)
+        _descriptor_extractor        = cv::ORB::create();
+        _parameters->descriptor_type = "ORB-256";
+    #endif
+  } else {
+    LOG_WARNING(std::cerr << "IntensityFeatureExtractor::configure|descriptor_type: " << _parameters->descriptor_type
+                          << " is not implemented, defaulting to ORB-256" << std::endl)
+    _descriptor_extractor        = cv::ORB::create();
+    _parameters->descriptor_type = "ORB-256";
+  }
+#endif
+
+  //ds on demand extraction requires the raw interface of our native extractor
+  if (_parameters->enable_lazy_descriptor_extraction) {
+    if (_parameters->descriptor_type == "BRIEF-256-NATIVE") {
+      _lazy_descriptor_extractor.reset(new BinaryDescriptorExtractor());
+    } else {
+      LOG_WARNING(std::cerr << "IntensityFeatureExtractor::configure|lazy descriptor extraction is not available for descriptor_type: "
+                            << _parameters->descriptor_type << ", extracting all descriptors" << std::endl)
+    }
+  }
+
+  //ds log chosen descriptor type and size
+  LOG_INFO(std::cerr << "IntensityFeatureExtractor::configure|descriptor_type: " << _parameters->descriptor_type
+                     << " (memory: " << SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS << "b)" << std::endl)
+
+  //ds allocate and initialize detector grid structure
+  _detectors           = new cv::Ptr<cv::FastFeatureDetector>*[_parameters->number_of_detectors_vertical];
+  _detector_regions    = new cv::Rect*[_parameters->number_of_detectors_vertical];
+  _detector_thresholds = new real*[_parameters->number_of_detectors_vertical];
+  _keypoints_per_detector = new std::vector<cv::KeyPoint>*[_parameters->number_of_detectors_vertical];
+  const real pixel_rows_per_detector = static_cast<real>(rows_)/_parameters->number_of_detectors_vertical;
+  const real pixel_cols_per_detector = static_cast<real>(cols_)/_parameters->number_of_detectors_horizontal;
+  for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
+    _detectors[r]           = new cv::Ptr<cv::FastFeatureDetector>[_parameters->number_of_detectors_horizontal];
+    _detector_regions[r]    = new cv::Rect[_parameters->number_of_detectors_horizontal];
+    _detector_thresholds[r] = new real[_parameters->number_of_detectors_horizontal];
+    _keypoints_per_detector[r] = new std::vector<cv::KeyPoint>[_parameters->number_of_detectors_horizontal];
+    for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
+#if CV_MAJOR_VERSION == 2
+      _detectors[r][c] = new cv::FastFeatureDetector(_parameters->detector_threshold_minimum);
+#else
+      _detectors[r][c] = cv::FastFeatureDetector::create(_parameters->detector_threshold_minimum);
+#endif
+      _detector_regions[r][c] = cv::Rect(std::round(c*pixel_cols_per_detector),
+                                         std::round(r*pixel_rows_per_detector),
+                                         pixel_cols_per_detector,
+                                         pixel_rows_per_detector);
+      _detector_thresholds[r][c] = _parameters->detector_threshold_minimum;
+    }
+  }
+  _number_of_detectors = _parameters->number_of_detectors_vertical*_parameters->number_of_detectors_horizontal;
+  LOG_INFO(std::cerr << "IntensityFeatureExtractor::configure|configured" << std::endl)
+}
+
+void IntensityFeatureExtractor::detectKeypoints(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_) {
+
+  //ds detect new keypoints in each image region - regions are independent and write into their own buffers
+  if (_worker_pool) {
+    _worker_pool->run(_number_of_detectors, [this, &intensity_image_](const Index& index_) {
+      _detectKeypointsInRegion(intensity_image_,
+                               index_/_parameters->number_of_detectors_horizontal,
+                               index_%_parameters->number_of_detectors_horizontal);
+    });
+  } else {
+    for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
+      for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
+        _detectKeypointsInRegion(intensity_image_, r, c);
+      }
+    }
+  }
+
+  _mergeKeypointsOfRegions(keypoints_);
+}
+
+void IntensityFeatureExtractor::detectKeypoints(const cv::Mat& intensity_image_,
+                                                std::vector<cv::KeyPoint>& keypoints_,
+                                                const std::vector<int32_t>& col_end_per_row_) {
+  if (col_end_per_row_.size() != static_cast<size_t>(intensity_image_.rows)) {
+    throw std::runtime_error("IntensityFeatureExtractor::detectKeypoints|invalid detection area");
+  }
+
+  //ds detect new keypoints in the covered part of each image region
+  if (_worker_pool) {
+    _worker_pool->run(_number_of_detectors, [this, &intensity_image_, &col_end_per_row_](const Index& index_) {
+      _detectKeypointsInRegion(intensity_image_,
+                               index_/_parameters->number_of_detectors_horizontal,
+                               index_%_parameters->number_of_detectors_horizontal,
+                               col_end_per_row_);
+    });
+  } else {
+    for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
+      for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
+        _detectKeypointsInRegion(intensity_image_, r, c, col_end_per_row_);
+      }
+    }
+  }
+  _mergeKeypointsOfRegions(keypoints_);
+}
+
+void IntensityFeatureExtractor::_mergeKeypointsOfRegions(std::vector<cv::KeyPoint>& keypoints_) const {
+
+  //ds merge region buffers in fixed grid order (deterministic keypoint ordering, independent of scheduling)
+  for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
+    for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
+      keypoints_.insert(keypoints_.end(), _keypoints_per_detector[r][c].begin(), _keypoints_per_detector[r][c].end());
+    }
+  }
+}
+
+void IntensityFeatureExtractor::_detectKeypointsInRegion(const cv::Mat& intensity_image_, const uint32_t& r_, const uint32_t& c_) {
+
+  //ds detect keypoints in current region
+  std::vector<cv::KeyPoint>& keypoints_per_detector = _keypoints_per_detector[r_][c_];
+  keypoints_per_detector.clear();
+  _detectors[r_][c_]->detect(intensity_image_(_detector_regions[r_][c_]), keypoints_per_detector);
+
+  //ds adapt the region threshold to the number of detected keypoints
+  _adaptDetectorThreshold(r_, c_, keypoints_per_detector.size());
+
+  //ds shift keypoint coordinates to whole image region
+  const cv::Point2f& offset = _detector_regions[r_][c_].tl(); // 사각형 영역의 Top-Left 포인트
+  std::for_each(keypoints_per_detector.begin(), keypoints_per_detector.end(), [&offset](cv::KeyPoint& keypoint_) {keypoint_.pt += offset;}); // Grid 좌표계에서 전체 이미지 전체 좌표계로 변경
+}
+
+void IntensityFeatureExtractor::_adaptDetectorThreshold(const uint32_t& r_, const uint32_t& c_, const real& number_of_keypoints_) {
+
+  //ds current threshold for this detector
+#if CV_MAJOR_VERSION == 2
+  real detector_threshold = _detectors[r_][c_]->getInt("threshold");
+#else
+  real detector_threshold = _detectors[r_][c_]->getThreshold();
+#endif
+
+  //ds compute point delta: 100% loss > -1, 100% gain > +1
+  const real delta = (number_of_keypoints_-_target_number_of_keypoints_per_detector)/_target_number_of_keypoints_per_detector;
+
+  //ds check if there's a significant loss of target points (delta is negative)
+  if (delta < -_parameters->target_number_of_keypoints_tolerance) { // Keypoint가 부족한 경우 Threshold 줄임
+
+    //ds compute new, lower threshold, capped and damped
+    const real change = std::max(delta, -_parameters->detector_threshold_maximum_change);
+
+    //ds always lower threshold by at least 1
+    detector_threshold += std::min(change*detector_threshold, -1.0);
+
+    //ds check minimum threshold
+    if (detector_threshold < _parameters->detector_threshold_minimum) {
+      detector_threshold = _parameters->detector_threshold_minimum;
+    }
+  }
+
+  //ds or if there's a significant gain of target points (delta is positive)
+  else if (delta > _parameters->target_number_of_keypoints_tolerance) { // Keypoint가 넘치는 경우, Threshold 늘림
+
+    //ds compute new, higher threshold - capped and damped
+    const real change = std::min(delta, _parameters->detector_threshold_maximum_change);
+
+    //ds always increase threshold by at least 1
+    detector_threshold += std::max(change*detector_threshold, 1.0);
+
+    //ds check maximum threshold
+    if (detector_threshold > _parameters->detector_threshold_maximum) {
+      detector_threshold = _parameters->detector_threshold_maximum;
+    }
+  }
+
+  //ds set threshold (no effect if not changed)
+  _detector_thresholds[r_][c_] = detector_threshold;
+}
+
+void IntensityFeatureExtractor::_detectKeypointsInRegion(const cv::Mat& intensity_image_,
+                                                         const uint32_t& r_,
+                                                         const uint32_t& c_,
+                                                         const std::vector<int32_t>& col_end_per_row_) {
+  std::vector<cv::KeyPoint>& keypoints_per_detector = _keypoints_per_detector[r_][c_];
+  keypoints_per_detector.clear();
+  const cv::Rect& region   = _detector_regions[r_][c_];
+  const int32_t row_end    = region.y+region.height;
+  const int32_t col_end    = region.x+region.width;
+  std::vector<cv::KeyPoint> keypoints_per_strip;
+  Count number_of_pixels_covered = 0;
+
+  //ds process the region in horizontal strips (keypoints are appended in row major order, as in a complete detection)
+  for (int32_t row_strip = region.y; row_strip < row_end; row_strip += _detection_strip_height_pixels) {
+    const int32_t row_strip_end = std::min(row_strip+_detection_strip_height_pixels, row_end);
+
+    //ds determine the covered columns of the strip
+    int32_t col_strip_end = region.x;
+    for (int32_t row = row_strip; row < row_strip_end; ++row) {
+      const int32_t col_end_row = std::min(col_end_per_row_[row], col_end);
+      col_strip_end = std::max(col_strip_end, col_end_row);
+      number_of_pixels_covered += std::max(col_end_row-region.x, 0);
+    }
+    if (col_strip_end == region.x) {
+      continue;
+    }
+
+    //ds detect in the strip extended by the margin (borders of the region are kept, as in a complete detection)
+    const int32_t row_window_begin = std::max(row_strip-_detection_strip_margin_pixels, region.y);
+    const int32_t row_window_end   = std::min(row_strip_end+_detection_strip_margin_pixels, row_end);
+    const int32_t col_window_end   = std::min(col_strip_end+_detection_strip_margin_pixels, col_end);
+    const cv::Rect window(region.x, row_window_begin, col_window_end-region.x, row_window_end-row_window_begin);
+    keypoints_per_strip.clear();
+    _detectors[r_][c_]->detect(intensity_image_(window), keypoints_per_strip);
+
+    //ds keep the keypoints inside the covered part of the strip (in image coordinates)
+    for (cv::KeyPoint& keypoint: keypoints_per_strip) {
+      keypoint.pt += cv::Point2f(window.tl());
+      const int32_t row = keypoint.pt.y;
+      const int32_t col = keypoint.pt.x;
+      if (row >= row_strip && row < row_strip_end && col < col_end_per_row_[row]) {
+        keypoints_per_detector.push_back(keypoint);
+      }
+    }
+  }
+
+  //ds adapt the region threshold to the keypoint count expected for the complete region (covered part extrapolated)
+  if (number_of_pixels_covered > 0) {
+    _adaptDetectorThreshold(r_, c_, static_cast<real>(keypoints_per_detector.size())*region.area()/number_of_pixels_covered);
+  }
+}
+
+void IntensityFeatureExtractor::computeDescriptors(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_) {
+  _descriptor_extractor->compute(intensity_image_, keypoints_, descriptors_);
+}
+
+void IntensityFeatureExtractor::prepareLazyDescriptors(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_) {
+  assert(isLazy());
+  _lazy_descriptor_extractor->setImage(intensity_image_);
+
+  //ds remove the same keypoints as the complete extraction would
+  keypoints_.erase(std::remove_if(keypoints_.begin(), keypoints_.end(), [this](const cv::KeyPoint& keypoint_) {
+    return !_lazy_descriptor_extractor->isDescribable(keypoint_);
+  }), keypoints_.end());
+}
+
+Descriptor IntensityFeatureExtractor::describe(const cv::KeyPoint& keypoint_) const {
+  assert(isLazy());
+  Descriptor descriptor = {};
+  _lazy_descriptor_extractor->computeDescriptor(keypoint_, descriptor.data());
+  return descriptor;
+}
+
+void IntensityFeatureExtractor::describeKeypoints(const cv::Mat& intensity_image_,
+                                                  std::vector<cv::KeyPoint>& keypoints_,
+                                                  DescriptorVector& descriptors_,
+                                                  std::vector<uint8_t>& is_described_) {
+  descriptors_.resize(keypoints_.size());
+  is_described_.assign(keypoints_.size(), 0);
+
+  //ds in lazy mode the image is already smoothed - we can directly evaluate the kernel for each keypoint
+  if (isLazy()) {
+    for (Index u = 0; u < keypoints_.size(); ++u) {
+      if (_lazy_descriptor_extractor->isDescribable(keypoints_[u])) {
+        _lazy_descriptor_extractor->computeDescriptor(keypoints_[u], descriptors_[u].data());
+        is_described_[u] = 1;
+      }
+    }
+    return;
+  }
+
+  //ds otherwise run a single extraction on all keypoints, the extractor may remove keypoints - we track them by class id
+  std::vector<cv::KeyPoint> keypoints(keypoints_);
+  for (Index u = 0; u < keypoints.size(); ++u) {
+    keypoints[u].class_id = u;
+  }
+  cv::Mat descriptors;
+  _descriptor_extractor->compute(intensity_image_, keypoints, descriptors);
+  for (int32_t row = 0; row < static_cast<int32_t>(keypoints.size()); ++row) {
+    const Index index = keypoints[row].class_id;
+    assert(index < keypoints_.size());
+    keypoints[row].class_id = keypoints_[index].class_id;
+    keypoints_[index]       = keypoints[row];
+    descriptors_[index]     = Descriptor::fromMat(descriptors, row);
+    is_described_[index]    = 1;
+  }
+}
+
+void IntensityFeatureExtractor::adjustDetectorThresholds() {
+  for (uint32_t r = 0; r < _parameters->number_of_detectors_vertical; ++r) {
+    for (uint32_t c = 0; c < _parameters->number_of_detectors_horizontal; ++c) {
+#if CV_MAJOR_VERSION == 2
+      _detectors[r][c]->setInt("threshold", _detector_thresholds[r][c]);
+#else
+      _detectors[r][c]->setThreshold(_detector_thresholds[r][c]);
+#endif
+    }
+  }
+}
+} //namespace proslam
@@ -1,26 +1,151 @@
 #pragma once
-#include "types/definitions.h"
+#include "types/parameters.h"
+#include "types/worker_pool.h"
+#include "types/descriptor.h"
+#include <memory>
+#include "binary_descriptor_extractor.h"
 
 
 
 namespace proslam {
 
+//! @class keypoint detection and descriptor extraction for a single image stream
+//! each image stream (e.g. left and right camera) owns an extractor, such that the adaptive detector thresholds
+//! only depend on the statistics of their own stream and streams can be processed concurrently
 class IntensityFeatureExtractor {
 public:
 
+  //! @brief constructs an unconfigured extractor
+  //! @param[in] parameters_ framepoint generation parameters (shared among streams)
+  IntensityFeatureExtractor(BaseFramePointGeneratorParameters* parameters_);
 
+  //! @brief frees the detector grid
+  ~IntensityFeatureExtractor();
+
+public:
+
+  //! @brief allocates the detector grid and the descriptor extractor for the given image dimensions
+  //! @param[in] rows_ number of image rows
+  //! @param[in] cols_ number of image columns
+  //! @param[in] target_number_of_keypoints_per_detector_ desired number of keypoints per detector region
+  //! @param[in] worker_pool_ optional worker threads for parallel detection over the detector grid
+  void configure(const int32_t& rows_,
+                 const int32_t& cols_,
+                 const real& target_number_of_keypoints_per_detector_,
+                 WorkerPool* worker_pool_ = nullptr);
+
+  //! @brief detects keypoints with the detector grid and adapts the detector region thresholds
+  //! @param[in] intensity_image_ image of this stream
+  //! @param[out] keypoints_ detected keypoints (appended in grid order)
+  void detectKeypoints(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_);
+
+  //! @brief detects keypoints only in a part of the image, the keypoints are identical to the ones of a complete detection
+  //! @brief that fall into the area - the detector thresholds are adapted to the count extrapolated to the complete regions
+  //! @param[in] intensity_image_ image of this stream
+  //! @param[out] keypoints_ detected keypoints (appended in grid order)
+  //! @param[in] col_end_per_row_ area to detect in: row r is covered for columns [0, col_end_per_row_[r]) (0: not covered)
+  void detectKeypoints(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, const std::vector<int32_t>& col_end_per_row_);
+
+  //! @brief extracts descriptors for the given keypoints (keypoints without valid descriptor are removed)
+  //! @param[in] intensity_image_ image of this stream
+  //! @param[in,out] keypoints_ keypoints to describe
+  //! @param[out] descriptors_ descriptor matrix with one row per keypoint
+  void computeDescriptors(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_);
+
+  //! @brief prepares lazy descriptor extraction: smooths the image once and removes keypoints without valid descriptor
+  //! @brief descriptors are then computed on demand with describe or by a matcher through lazyDescriptorExtractor
+  //! @param[in] intensity_image_ image of this stream
+  //! @param[in,out] keypoints_ keypoints to describe later
+  void prepareLazyDescriptors(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_);
+
+  //! @brief computes the descriptor of a single keypoint in the image of the last call to prepareLazyDescriptors
+  //! @param[in] keypoint_ keypoint returned by prepareLazyDescriptors
+  //! @return descriptor of the keypoint
+  Descriptor describe(const cv::KeyPoint& keypoint_) const;
+
+  //! @brief computes descriptors for an arbitrary set of keypoints with a single extraction, results stay at the keypoint index
+  //! @brief in lazy mode the prepared image is used directly (no additional smoothing)
+  //! @param[in] intensity_image_ image of this stream (in lazy mode: the image of the last call to prepareLazyDescriptors)
+  //! @param[in,out] keypoints_ keypoints to describe (may be adjusted by the extractor, e.g. orientation)
+  //! @param[out] descriptors_ descriptor for each keypoint (only valid if described)
+  //! @param[out] is_described_ for each keypoint: 1 if a descriptor could be computed, 0 otherwise
+  void describeKeypoints(const cv::Mat& intensity_image_,
+                         std::vector<cv::KeyPoint>& keypoints_,
+                         DescriptorVector& descriptors_,
+                         std::vector<uint8_t>& is_described_);
+
+  //! @brief applies the thresholds adapted during the last detection to the detectors
+  void adjustDetectorThresholds();
+
+//ds getters/setters
+public:
+
+  cv::Ptr<cv::DescriptorExtractor> descriptorExtractor() const {return _descriptor_extractor;}
+  const uint32_t& numberOfDetectors() const {return _number_of_detectors;}
+  const BinaryDescriptorExtractor* lazyDescriptorExtractor() const {return _lazy_descriptor_extractor.get();}
+  const bool isLazy() const {return _lazy_descriptor_extractor != nullptr;}
+
+//ds helpers
 protected:
 
+  //! @brief detects keypoints in a single detector region and adapts the region threshold
+  //! @brief thread safe for different regions, the result is stored in the region buffer _keypoints_per_detector[r_][c_]
+  //! @param[in] intensity_image_ complete image
+  //! @param[in] r_ detector row
+  //! @param[in] c_ detector column
+  void _detectKeypointsInRegion(const cv::Mat& intensity_image_, const uint32_t& r_, const uint32_t& c_);
+
+  //! @brief detects keypoints in the part of a single detector region covered by col_end_per_row_ and adapts the region threshold
+  //! @brief to the keypoint count extrapolated from the covered to the complete region area (no adaption if nothing is covered)
+  //! @brief the covered part is processed in horizontal strips, each extended by a margin such that FAST scores
+  //! @brief and non-maximum suppression inside the strip are not affected by the strip borders
+  void _detectKeypointsInRegion(const cv::Mat& intensity_image_,
+                                const uint32_t& r_,
+                                const uint32_t& c_,
+                                const std::vector<int32_t>& col_end_per_row_);
+
+  //! @brief adapts the threshold of a single detector region towards the target number of keypoints (applied with adjustDetectorThresholds)
+  //! @param[in] r_ detector row
+  //! @param[in] c_ detector column
+  //! @param[in] number_of_keypoints_ number of keypoints (expected) in the complete region
+  void _adaptDetectorThreshold(const uint32_t& r_, const uint32_t& c_, const real& number_of_keypoints_);
+
+  //! @brief appends the keypoints of all region buffers in fixed grid order
+  void _mergeKeypointsOfRegions(std::vector<cv::KeyPoint>& keypoints_) const;
+
+protected:
+
+  //! @brief configuration
+  BaseFramePointGeneratorParameters* _parameters;
+
+  //! @brief desired number of keypoints per detector region
+  real _target_number_of_keypoints_per_detector = 0;
+
   //! @brief grid of detectors (equally distributed over the image with size=number_of_detectors_per_dimension*number_of_detectors_per_dimension)
   cv::Ptr<cv::FastFeatureDetector>** _detectors = nullptr;
   real** _detector_thresholds                   = nullptr;
 
   //! @brief number of detectors
-  //! @brief the same for all image streams
-  uint32_t _number_of_detectors;
+  uint32_t _number_of_detectors = 0;
 
   //! @brief image region for each detector
-  //! @brief the same for all image streams
   cv::Rect** _detector_regions = nullptr;
+
+  //! @brief keypoint buffer for each detector (merged in grid order after detection)
+  std::vector<cv::KeyPoint>** _keypoints_per_detector = nullptr;
+
+  //! @brief partial detection: strip height and margin (FAST circle radius 3 plus non-maximum suppression neighborhood 1)
+  static constexpr int32_t _detection_strip_height_pixels = 32;
+  static constexpr int32_t _detection_strip_margin_pixels = 4;
+
+  //! @brief descriptor extraction
+  cv::Ptr<cv::DescriptorExtractor> _descriptor_extractor;
+
+  //! @brief on demand descriptor extraction (only set in lazy mode, separate from _descriptor_extractor
+  //! @brief such that other users of the descriptor extractor do not overwrite the prepared image)
+  std::unique_ptr<BinaryDescriptorExtractor> _lazy_descriptor_extractor;
+
+  //! @brief worker threads for parallel detection (not owned, only set if enabled)
+  WorkerPool* _worker_pool = nullptr;
 };
 } //namespace proslam
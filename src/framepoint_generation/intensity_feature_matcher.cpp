@@ -12,61 +12,132 @@ IntensityFeatureMatcher::IntensityFeatureMatcher() {
 
 IntensityFeatureMatcher::~IntensityFeatureMatcher() {
   LOG_INFO(std::cerr << "IntensityFeatureMatcher::~IntensityFeatureMatcher|destroying" << std::endl)
-  for (int32_t r = 0; r < number_of_rows; ++r) {
-    delete[] feature_lattice[r];
-  }
-  delete[] feature_lattice;
-  for (IntensityFeature* feature: feature_vector) {
-    delete feature;
-  }
   feature_vector.clear();
+  _features.clear();
+  _cells.clear();
   LOG_INFO(std::cerr << "IntensityFeatureMatcher::~IntensityFeatureMatcher|destroyed" << std::endl)
 }
 
-void IntensityFeatureMatcher::configure(const int32_t& rows_, const int32_t& cols_) {
+void IntensityFeatureMatcher::configure(const int32_t& rows_, const int32_t& cols_, const int32_t& cell_size_pixels_) {
   LOG_INFO(std::cerr << "IntensityFeatureMatcher::configure|configuring" << std::endl)
   if (rows_ <= 0 || cols_ <= 0) {
-    throw std::runtime_error("KeypointWithDescriptorLattice::configure|invalid image dimensions");
+    throw std::runtime_error("IntensityFeatureMatcher::configure|invalid image dimensions");
   }
-  if (feature_lattice) {
-    throw std::runtime_error("KeypointWithDescriptorLattice::configure|lattice already allocated");
+  if (cell_size_pixels_ <= 0) {
+    throw std::runtime_error("IntensityFeatureMatcher::configure|invalid cell size");
   }
-
-  //ds initialize empty lattice
-  feature_lattice = new IntensityFeature**[rows_];
-  for (int32_t r = 0; r < rows_; ++r) {
-    feature_lattice[r] = new IntensityFeature*[cols_];
-    for (int32_t c = 0; c < cols_; ++c) {
-      feature_lattice[r][c] = nullptr;
-    }
+  if (!_cells.empty()) {
+    throw std::runtime_error("IntensityFeatureMatcher::configure|grid already allocated");
   }
-  number_of_rows = rows_;
-  number_of_cols = cols_;
-  LOG_INFO(std::cerr << "IntensityFeatureMatcher::configure|configured" << std::endl)
+
+  //ds initialize empty grid
+  number_of_rows       = rows_;
+  number_of_cols       = cols_;
+  _cell_size_pixels    = cell_size_pixels_;
+  _number_of_cell_rows = (rows_+cell_size_pixels_-1)/cell_size_pixels_;
+  _number_of_cell_cols = (cols_+cell_size_pixels_-1)/cell_size_pixels_;
+  _cells.resize(_number_of_cell_rows*_number_of_cell_cols);
+  _occupied_cells.clear();
+  LOG_INFO(std::cerr << "IntensityFeatureMatcher::configure|configured (cell size: " << _cell_size_pixels
+                     << " grid: " << _number_of_cell_rows << "x" << _number_of_cell_cols << ")" << std::endl)
 }
 
 void IntensityFeatureMatcher::setFeatures(const std::vector<cv::KeyPoint>& keypoints_, const cv::Mat& descriptors_) {
   if (keypoints_.size() != static_cast<size_t>(descriptors_.rows)) {
-    throw std::runtime_error("KeypointWithDescriptorLattice::setFeatures|mismatching keypoints and descriptor numbers");
+    throw std::runtime_error("IntensityFeatureMatcher::setFeatures|mismatching keypoints and descriptor numbers");
   }
+  _resetFeatures(keypoints_.size());
+  _descriptor_extractor = nullptr;
 
-  //ds clear the lattice - freeing remaining features
-  for (int32_t r = 0; r < number_of_rows; ++r) {
-    for (int32_t c = 0; c < number_of_cols; ++c) {
-      feature_lattice[r][c] = nullptr;
-    }
+  //ds fill in features - overwriting the features of the previous call (the storage is only reallocated if it grows)
+  for (uint32_t index = 0; index < keypoints_.size(); ++index) {
+    IntensityFeature* feature = &_features[index];
+    *feature              = IntensityFeature(keypoints_[index], Descriptor::fromMat(descriptors_, index), index);
+    feature_vector[index] = feature;
+    _addToGrid(feature);
+  }
+}
+
+void IntensityFeatureMatcher::setFeatures(const std::vector<cv::KeyPoint>& keypoints_, const BinaryDescriptorExtractor* descriptor_extractor_) {
+  if (!descriptor_extractor_) {
+    throw std::runtime_error("IntensityFeatureMatcher::setFeatures|invalid descriptor extractor");
   }
-  for (IntensityFeature* feature: feature_vector) {
-    delete feature;
+  _resetFeatures(keypoints_.size());
+  _descriptor_extractor = descriptor_extractor_;
+
+  //ds reset described flags (the flag storage is only reallocated if it grows)
+  if (keypoints_.size() > _capacity_is_described) {
+    _capacity_is_described = keypoints_.size();
+    _is_described.reset(new std::atomic<bool>[_capacity_is_described]);
+  }
+  for (size_t index = 0; index < keypoints_.size(); ++index) {
+    _is_described[index].store(false, std::memory_order_relaxed);
   }
 
-  //ds fill in features
-  feature_vector.resize(keypoints_.size());
+  //ds fill in features without descriptors
   for (uint32_t index = 0; index < keypoints_.size(); ++index) {
-    IntensityFeature* feature = new IntensityFeature(keypoints_[index], descriptors_.row(index), index);
+    IntensityFeature* feature = &_features[index];
+    *feature              = IntensityFeature(keypoints_[index], index);
     feature_vector[index] = feature;
-    feature_lattice[feature->row][feature->col] = feature;
+    _addToGrid(feature);
+  }
+}
+
+void IntensityFeatureMatcher::resetMatches() {
+
+  //ds all features of a cell are active again (removed features were kept behind the active ones)
+  for (const uint32_t& index_cell: _occupied_cells) {
+    _cells[index_cell].number_of_active_features = _cells[index_cell].features.size();
+  }
+
+  //ds restore the feature vector in the order of setFeatures
+  feature_vector.resize(_features.size());
+  _is_matched.assign(_features.size(), false);
+  for (uint32_t index = 0; index < _features.size(); ++index) {
+    feature_vector[index] = &_features[index];
+  }
+}
+
+void IntensityFeatureMatcher::_resetFeatures(const size_t& number_of_features_) {
+
+  //ds clear the grid - only the cells that were filled before
+  for (const uint32_t& index_cell: _occupied_cells) {
+    _cells[index_cell].features.clear();
+    _cells[index_cell].number_of_active_features = 0;
+  }
+  _occupied_cells.clear();
+  _features.resize(number_of_features_);
+  feature_vector.resize(number_of_features_);
+  _is_matched.assign(number_of_features_, false);
+}
+
+void IntensityFeatureMatcher::_addToGrid(IntensityFeature* feature_) {
+  assert(feature_->row >= 0 && feature_->row < number_of_rows);
+  assert(feature_->col >= 0 && feature_->col < number_of_cols);
+  const uint32_t index_cell = (feature_->row/_cell_size_pixels)*_number_of_cell_cols+feature_->col/_cell_size_pixels;
+  Cell& cell = _cells[index_cell];
+  if (cell.features.empty()) {
+    _occupied_cells.push_back(index_cell);
+  }
+
+  //ds features are only added in setFeatures, before any feature is removed
+  assert(cell.number_of_active_features == cell.features.size());
+  cell.features.push_back(feature_);
+  ++cell.number_of_active_features;
+}
+
+void IntensityFeatureMatcher::_describe(const size_t& index_in_vector_) const {
+  std::lock_guard<std::mutex> lock(_describe_mutexes[index_in_vector_%_number_of_describe_mutexes]);
+
+  //ds another thread might have described the feature while we were waiting
+  if (_is_described[index_in_vector_].load(std::memory_order_relaxed)) {
+    return;
   }
+
+  //ds the descriptor is a cache owned by this matcher
+  IntensityFeature& feature = const_cast<IntensityFeature&>(_features[index_in_vector_]);
+  _descriptor_extractor->computeDescriptor(feature.keypoint, feature.descriptor.data());
+  _is_described[index_in_vector_].store(true, std::memory_order_release);
 }
 
 void IntensityFeatureMatcher::sortFeatureVector() {
@@ -77,31 +148,44 @@ void IntensityFeatureMatcher::sortFeatureVector() {
 
 IntensityFeature* IntensityFeatureMatcher::getMatchingFeatureInRectangularRegion(const int32_t& row_reference_,
                                                                                  const int32_t& col_reference_,
-                                                                                 const cv::Mat& descriptor_reference_,
+                                                                                 const Descriptor& descriptor_reference_,
                                                                                  const int32_t& row_start_point,
                                                                                  const int32_t& row_end_point,
                                                                                  const int32_t& col_start_point,
                                                                                  const int32_t& col_end_point,
                                                                                  const real& maximum_descriptor_distance_tracking_,
                                                                                  const bool track_by_appearance_,
-                                                                                 real& descriptor_distance_best_) {
+                                                                                 real& descriptor_distance_best_) const {
   descriptor_distance_best_ = maximum_descriptor_distance_tracking_;
-  int32_t row_best = -1;
-  int32_t col_best = -1;
+  if (row_start_point >= row_end_point || col_start_point >= col_end_point) {
+    return nullptr;
+  }
+  IntensityFeature* feature_best = nullptr;
+
+  //ds cells overlapping the search region
+  const int32_t cell_row_start = row_start_point/_cell_size_pixels;
+  const int32_t cell_row_end   = (row_end_point-1)/_cell_size_pixels;
+  const int32_t cell_col_start = col_start_point/_cell_size_pixels;
+  const int32_t cell_col_end   = (col_end_point-1)/_cell_size_pixels;
 
   //ds locate best match in appearance
   if (track_by_appearance_) {
-    for (int32_t row = row_start_point; row < row_end_point; ++row) {
-      for (int32_t col = col_start_point; col < col_end_point; ++col) {
-        if (feature_lattice[row][col]) {
-          const real descriptor_distance = cv::norm(descriptor_reference_,
-                                                    feature_lattice[row][col]->descriptor,
-                                                    SRRG_PROSLAM_DESCRIPTOR_NORM);
-
-          if (descriptor_distance < descriptor_distance_best_) {
+    for (int32_t cell_row = cell_row_start; cell_row <= cell_row_end; ++cell_row) {
+      for (int32_t cell_col = cell_col_start; cell_col <= cell_col_end; ++cell_col) {
+        const Cell& cell = _cells[cell_row*_number_of_cell_cols+cell_col];
+        for (size_t index = 0; index < cell.number_of_active_features; ++index) {
+          IntensityFeature* feature = cell.features[index];
+          if (feature->row < row_start_point || feature->row >= row_end_point ||
+              feature->col < col_start_point || feature->col >= col_end_point) {
+            continue;
+          }
+          const real descriptor_distance = HammingDistance::compute(descriptor_reference_, descriptor(feature));
+
+          //ds if better than best so far (ties are resolved as in a row major scan of the region)
+          if (descriptor_distance < descriptor_distance_best_ ||
+              (feature_best && descriptor_distance == descriptor_distance_best_ && _isBefore(feature, feature_best))) {
             descriptor_distance_best_ = descriptor_distance;
-            row_best = row;
-            col_best = col;
+            feature_best              = feature;
           }
         }
       }
@@ -110,48 +194,149 @@ IntensityFeature* IntensityFeatureMatcher::getMatchingFeatureInRectangularRegion
   //ds locate best match in projection error, within maximum appearance distance
   } else {
     uint32_t projection_distance_pixels_best = 10000;
-    for (int32_t row = row_start_point; row < row_end_point; ++row) {
-      for (int32_t col = col_start_point; col < col_end_point; ++col) {
-        if (feature_lattice[row][col]) {
-          const real descriptor_distance = cv::norm(descriptor_reference_,
-                                                    feature_lattice[row][col]->descriptor,
-                                                    SRRG_PROSLAM_DESCRIPTOR_NORM);
+    for (int32_t cell_row = cell_row_start; cell_row <= cell_row_end; ++cell_row) {
+      for (int32_t cell_col = cell_col_start; cell_col <= cell_col_end; ++cell_col) {
+        const Cell& cell = _cells[cell_row*_number_of_cell_cols+cell_col];
+        for (size_t index = 0; index < cell.number_of_active_features; ++index) {
+          IntensityFeature* feature = cell.features[index];
+          if (feature->row < row_start_point || feature->row >= row_end_point ||
+              feature->col < col_start_point || feature->col >= col_end_point) {
+            continue;
+          }
+          const real descriptor_distance = HammingDistance::compute(descriptor_reference_, descriptor(feature));
           if (descriptor_distance < maximum_descriptor_distance_tracking_) {
 
             //ds compute projection distance
-            const uint32_t row_distance_pixels        = row_reference_-row;
-            const uint32_t col_distance_pixels        = col_reference_-col;
+            const uint32_t row_distance_pixels        = row_reference_-feature->row;
+            const uint32_t col_distance_pixels        = col_reference_-feature->col;
             const uint32_t projection_distance_pixels = row_distance_pixels*row_distance_pixels+col_distance_pixels*col_distance_pixels;
 
-            //ds if better than best so far
-            if (projection_distance_pixels < projection_distance_pixels_best) {
+            //ds if better than best so far (ties are resolved as in a row major scan of the region)
+            if (projection_distance_pixels < projection_distance_pixels_best ||
+                (feature_best && projection_distance_pixels == projection_distance_pixels_best && _isBefore(feature, feature_best))) {
               projection_distance_pixels_best = projection_distance_pixels;
               descriptor_distance_best_       = descriptor_distance;
-              row_best = row;
-              col_best = col;
+              feature_best                    = feature;
             }
           }
         }
       }
     }
   }
+  return feature_best;
+}
 
-  //ds if we found a match
-  if (row_best != -1) {
-    return feature_lattice[row_best][col_best];
-  } else {
+IntensityFeature* IntensityFeatureMatcher::getMatchingFeatureInRectangularRegion(const int32_t& row_reference_,
+                                                                                 const int32_t& col_reference_,
+                                                                                 const Descriptor& descriptor_reference_,
+                                                                                 const int32_t& row_start_point,
+                                                                                 const int32_t& row_end_point,
+                                                                                 const int32_t& col_start_point,
+                                                                                 const int32_t& col_end_point,
+                                                                                 const real& maximum_descriptor_distance_tracking_,
+                                                                                 const bool track_by_appearance_,
+                                                                                 real& descriptor_distance_best_,
+                                                                                 RegionCache& cache_) const {
+  descriptor_distance_best_ = maximum_descriptor_distance_tracking_;
+  if (row_start_point >= row_end_point || col_start_point >= col_end_point) {
     return nullptr;
   }
+
+  //ds keep the cached distances of features inside the search region
+  size_t number_of_cached_features = 0;
+  for (const std::pair<IntensityFeature*, real>& entry: cache_.distances) {
+    const IntensityFeature* feature = entry.first;
+    if (feature->row >= row_start_point && feature->row < row_end_point &&
+        feature->col >= col_start_point && feature->col < col_end_point) {
+      cache_.distances[number_of_cached_features] = entry;
+      ++number_of_cached_features;
+    }
+  }
+  cache_.distances.resize(number_of_cached_features);
+
+  //ds add the features of the search region outside of the cached region - including the ones removed from the grid
+  //ds (they might become available again after resetMatches), their distance is computed only once they are available
+  const int32_t cell_row_start = row_start_point/_cell_size_pixels;
+  const int32_t cell_row_end   = (row_end_point-1)/_cell_size_pixels;
+  const int32_t cell_col_start = col_start_point/_cell_size_pixels;
+  const int32_t cell_col_end   = (col_end_point-1)/_cell_size_pixels;
+  for (int32_t cell_row = cell_row_start; cell_row <= cell_row_end; ++cell_row) {
+    for (int32_t cell_col = cell_col_start; cell_col <= cell_col_end; ++cell_col) {
+      for (IntensityFeature* feature: _cells[cell_row*_number_of_cell_cols+cell_col].features) {
+        if (feature->row < row_start_point || feature->row >= row_end_point ||
+            feature->col < col_start_point || feature->col >= col_end_point) {
+          continue;
+        }
+        if (feature->row >= cache_.row_start_point && feature->row < cache_.row_end_point &&
+            feature->col >= cache_.col_start_point && feature->col < cache_.col_end_point) {
+          continue;
+        }
+        cache_.distances.push_back(std::make_pair(feature, -1));
+      }
+    }
+  }
+  cache_.row_start_point = row_start_point;
+  cache_.row_end_point   = row_end_point;
+  cache_.col_start_point = col_start_point;
+  cache_.col_end_point   = col_end_point;
+
+  //ds locate the best match among the available features - with the same criteria as the search without cache
+  IntensityFeature* feature_best = nullptr;
+  uint32_t projection_distance_pixels_best = 10000;
+  for (std::pair<IntensityFeature*, real>& entry: cache_.distances) {
+    IntensityFeature* feature = entry.first;
+    if (_is_matched[feature->index_in_vector]) {
+      continue;
+    }
+    if (entry.second < 0) {
+      entry.second = HammingDistance::compute(descriptor_reference_, descriptor(feature));
+    }
+    const real& descriptor_distance = entry.second;
+
+    //ds locate best match in appearance
+    if (track_by_appearance_) {
+      if (descriptor_distance < descriptor_distance_best_ ||
+          (feature_best && descriptor_distance == descriptor_distance_best_ && _isBefore(feature, feature_best))) {
+        descriptor_distance_best_ = descriptor_distance;
+        feature_best              = feature;
+      }
+
+    //ds locate best match in projection error, within maximum appearance distance
+    } else if (descriptor_distance < maximum_descriptor_distance_tracking_) {
+      const uint32_t row_distance_pixels        = row_reference_-feature->row;
+      const uint32_t col_distance_pixels        = col_reference_-feature->col;
+      const uint32_t projection_distance_pixels = row_distance_pixels*row_distance_pixels+col_distance_pixels*col_distance_pixels;
+      if (projection_distance_pixels < projection_distance_pixels_best ||
+          (feature_best && projection_distance_pixels == projection_distance_pixels_best && _isBefore(feature, feature_best))) {
+        projection_distance_pixels_best = projection_distance_pixels;
+        descriptor_distance_best_       = descriptor_distance;
+        feature_best                    = feature;
+      }
+    }
+  }
+  return feature_best;
+}
+
+void IntensityFeatureMatcher::removeFromGrid(const IntensityFeature* feature_) {
+  Cell& cell = _cells[(feature_->row/_cell_size_pixels)*_number_of_cell_cols+feature_->col/_cell_size_pixels];
+  IntensityFeaturePointerVector::iterator end_active = cell.features.begin()+cell.number_of_active_features;
+  IntensityFeaturePointerVector::iterator iterator   = std::find(cell.features.begin(), end_active, feature_);
+  if (iterator != end_active) {
+
+    //ds the order within a cell is irrelevant for the search - the feature is moved behind the active ones
+    std::iter_swap(iterator, end_active-1);
+    --cell.number_of_active_features;
+  }
 }
 
-void IntensityFeatureMatcher::prune(const std::set<uint32_t>& matched_indices_) {
+void IntensityFeatureMatcher::prune() {
 
-  //ds remove matched indices from candidate pools
+  //ds remove matched features from candidate pools
   size_t number_of_unmatched_elements = 0;
   for (size_t index = 0; index < feature_vector.size(); ++index) {
 
-    //ds if we haven't matched this index yet
-    if (matched_indices_.count(index) == 0) {
+    //ds if we haven't matched this feature yet
+    if (!_is_matched[feature_vector[index]->index_in_vector]) {
 
       //ds keep the element (this operation is not problemenatic since we do not loop reversely here)
       feature_vector[number_of_unmatched_elements] = feature_vector[index];
@@ -1,6 +1,8 @@
 #pragma once
 #include "intensity_feature_extractor.h"
 #include "types/frame_point.h"
+#include <atomic>
+#include <mutex>
 
 
 
@@ -10,34 +12,104 @@ namespace proslam {
 class IntensityFeatureMatcher {
 public:
 
+  //! @brief all features of a rectangular region with their descriptor distances to a fixed reference (e.g. a tracked point)
+  //! @brief kept across local searches for the same reference, valid until the next call to setFeatures
+  struct RegionCache {
+    int32_t row_start_point = 0;
+    int32_t row_end_point   = 0;
+    int32_t col_start_point = 0;
+    int32_t col_end_point   = 0;
+
+    //! @brief features in the region and their descriptor distance (negative if not computed yet)
+    std::vector<std::pair<IntensityFeature*, real>> distances;
+
+    //! @brief empties the region (the storage is kept)
+    void clear() {row_start_point = row_end_point = col_start_point = col_end_point = 0; distances.clear();}
+  };
+
   IntensityFeatureMatcher();
   ~IntensityFeatureMatcher();
 
 public:
 
-  //ds configure matcher
-  void configure(const int32_t& rows_, const int32_t& cols_);
+  //! @brief configures the spatial index for the given image dimensions
+  //! @param[in] rows_ number of image rows
+  //! @param[in] cols_ number of image columns
+  //! @param[in] cell_size_pixels_ side length of a grid cell (ideally in the order of the search window radius)
+  void configure(const int32_t& rows_, const int32_t& cols_, const int32_t& cell_size_pixels_);
 
-  //ds create features from keypoints and descriptors
+  //ds create features from keypoints and descriptors (invalidates all features of the previous call)
   void setFeatures(const std::vector<cv::KeyPoint>& keypoints_, const cv::Mat& descriptors_);
 
+  //! @brief creates features from keypoints without descriptors (invalidates all features of the previous call)
+  //! @brief the descriptor of a feature is computed the first time it is requested through descriptor
+  //! @param[in] keypoints_ describable keypoints
+  //! @param[in] descriptor_extractor_ extractor prepared for the image of the keypoints (must stay valid until the next call)
+  void setFeatures(const std::vector<cv::KeyPoint>& keypoints_, const BinaryDescriptorExtractor* descriptor_extractor_);
+
+  //! @brief returns the descriptor of a feature, computing it if not available yet (thread safe)
+  //! @param[in] feature_ feature of this matcher
+  //! @return feature descriptor (valid until the next call to setFeatures)
+  inline const Descriptor& descriptor(const IntensityFeature* feature_) const {
+    if (_descriptor_extractor && !_is_described[feature_->index_in_vector].load(std::memory_order_acquire)) {
+      _describe(feature_->index_in_vector);
+    }
+    return feature_->descriptor;
+  }
+
+  //! @brief checks whether the descriptor of a feature is available without computation
+  inline bool isDescribed(const IntensityFeature* feature_) const {
+    return (!_descriptor_extractor || _is_described[feature_->index_in_vector].load(std::memory_order_acquire));
+  }
+
+  //! @brief restores the state after the last call to setFeatures: all features are unmatched and in the grid again
+  //! @brief feature descriptors (including the ones computed on demand) are kept, no feature is recreated
+  void resetMatches();
+
   //ds sort all input vectors by ascending row positions (preparation for stereo matching)
   void sortFeatureVector();
 
-  //ds performs a local search in a rectangular area on the feature lattice
+  //! @brief performs a local search in a rectangular area, only features in the cells overlapping the area are visited
+  //! @brief ties are resolved in favor of the feature with the lowest (row, col) position
   IntensityFeature* getMatchingFeatureInRectangularRegion(const int32_t& row_reference_,
                                                           const int32_t& col_reference_,
-                                                          const cv::Mat& descriptor_reference_,
+                                                          const Descriptor& descriptor_reference_,
                                                           const int32_t& row_start_point,
                                                           const int32_t& row_end_point,
                                                           const int32_t& col_start_point,
                                                           const int32_t& col_end_point,
                                                           const real& maximum_descriptor_distance_tracking_,
                                                           const bool track_by_appearance_,
-                                                          real& descriptor_distance_best_);
+                                                          real& descriptor_distance_best_) const;
+
+  //! @brief performs the same local search for the reference of a region cache (thread safe for distinct caches)
+  //! @brief only features outside the cached region are compared, the cache is updated to the searched region
+  //! @param[in,out] cache_ distances of the previous searches for this reference (empty for the first search)
+  IntensityFeature* getMatchingFeatureInRectangularRegion(const int32_t& row_reference_,
+                                                          const int32_t& col_reference_,
+                                                          const Descriptor& descriptor_reference_,
+                                                          const int32_t& row_start_point,
+                                                          const int32_t& row_end_point,
+                                                          const int32_t& col_start_point,
+                                                          const int32_t& col_end_point,
+                                                          const real& maximum_descriptor_distance_tracking_,
+                                                          const bool track_by_appearance_,
+                                                          real& descriptor_distance_best_,
+                                                          RegionCache& cache_) const;
+
+  //! @brief marks a feature as matched, it is removed from the feature vector in the next call to prune
+  //! @param[in] feature_ matched feature
+  inline void markAsMatched(const IntensityFeature* feature_) {_is_matched[feature_->index_in_vector] = true;}
 
-  //ds prunes features from feature vector if existing
-  void prune(const std::set<uint32_t>& matched_indices_);
+  //! @brief checks whether a feature has been marked as matched since the last call to setFeatures
+  inline bool isMatched(const IntensityFeature* feature_) const {return _is_matched[feature_->index_in_vector];}
+
+  //! @brief removes all features marked as matched from the feature vector (preserving the order of the remaining ones)
+  void prune();
+
+  //! @brief removes a feature from the spatial index (it is not considered in further local searches)
+  //! @param[in] feature_ feature to remove (the feature vector is not modified)
+  void removeFromGrid(const IntensityFeature* feature_);
 
 //ds attributes
 public:
@@ -45,7 +117,58 @@ public:
   int32_t number_of_rows = 0;
   int32_t number_of_cols = 0;
   IntensityFeaturePointerVector feature_vector;
-  IntensityFeature*** feature_lattice = nullptr;
+
+//ds helpers
+protected:
+
+  //! @brief computes and stores the descriptor of a feature (called at most once per feature and call to setFeatures)
+  void _describe(const size_t& index_in_vector_) const;
+
+  //! @brief clears the grid and resizes the feature storage (shared by both setFeatures variants)
+  void _resetFeatures(const size_t& number_of_features_);
+
+  //! @brief inserts a feature into the grid
+  void _addToGrid(IntensityFeature* feature_);
+
+  //! @brief row major ordering of feature positions (features at the same position are ordered by index)
+  static inline bool _isBefore(const IntensityFeature* a_, const IntensityFeature* b_) {
+    return (a_->row < b_->row || (a_->row == b_->row && (a_->col < b_->col || (a_->col == b_->col && a_->index_in_vector < b_->index_in_vector))));
+  }
+
+//ds attributes
+protected:
+
+  //! @brief contiguous feature storage, reused for every call to setFeatures (feature_vector points into it)
+  std::vector<IntensityFeature> _features;
+
+  //! @brief grid cell: features removed from the grid are kept behind the active ones until the next call to setFeatures
+  struct Cell {
+    IntensityFeaturePointerVector features;
+    size_t number_of_active_features = 0;
+  };
+
+  //! @brief spatial index: features bucketed in square cells of _cell_size_pixels (row major)
+  int32_t _cell_size_pixels    = 0;
+  int32_t _number_of_cell_rows = 0;
+  int32_t _number_of_cell_cols = 0;
+  std::vector<Cell> _cells;
+
+  //! @brief cells filled in the last call to setFeatures (cleared in the next call)
+  std::vector<uint32_t> _occupied_cells;
+
+  //! @brief matched flag for each feature (indexed by IntensityFeature::index_in_vector, reset in setFeatures)
+  std::vector<bool> _is_matched;
+
+  //! @brief on demand descriptor extraction (not owned, only set in lazy mode)
+  const BinaryDescriptorExtractor* _descriptor_extractor = nullptr;
+
+  //! @brief described flag for each feature in lazy mode (indexed by IntensityFeature::index_in_vector, only grows)
+  std::unique_ptr<std::atomic<bool>[]> _is_described;
+  size_t _capacity_is_described = 0;
+
+  //! @brief striped locks guarding the descriptor computation (features are distributed by index)
+  static constexpr uint32_t _number_of_describe_mutexes = 64;
+  mutable std::mutex _describe_mutexes[_number_of_describe_mutexes];
 
 };
 } //namespace proslam
@@ -3,7 +3,8 @@
 namespace proslam {
 
 StereoFramePointGenerator::StereoFramePointGenerator(StereoFramePointGeneratorParameters* parameters_): BaseFramePointGenerator(parameters_),
-                                                                                                        _parameters(parameters_) {
+                                                                                                        _parameters(parameters_),
+                                                                                                        _feature_extractor_right(parameters_) {
   _epipolar_search_offsets_pixel.clear();
   LOG_INFO(std::cerr << "StereoFramePointGenerator::StereoFramePointGenerator|constructed" << std::endl)
 }
@@ -34,8 +35,23 @@ void StereoFramePointGenerator::configure(){
   _c_y = _camera_right->cameraMatrix()(1,2);
   _b_x = _baseline_pixelsmeters;
 
+  //ds allocate worker threads for concurrent processing of the image streams if not already available
+  if ((_parameters->enable_parallel_stereo_extraction ||
+       _parameters->enable_parallel_stereo_matching   ||
+       _parameters->enable_parallel_tracking) && !_worker_pool) {
+    _worker_pool = new WorkerPool(_parameters->number_of_worker_threads);
+    LOG_INFO(std::cerr << "StereoFramePointGenerator::configure|parallel processing enabled (threads: "
+                       << _worker_pool->numberOfThreads() << ")" << std::endl)
+  }
+
+  //ds allocate detectors and descriptor extractor for the right image stream
+  _feature_extractor_right.configure(_number_of_rows_image,
+                                     _number_of_cols_image,
+                                     _target_number_of_keypoints_per_detector,
+                                     _parameters->enable_parallel_keypoint_detection? _worker_pool: nullptr);
+
   //ds initialize feature matcher
-  _feature_matcher_right.configure(_number_of_rows_image, _number_of_cols_image);
+  _feature_matcher_right.configure(_number_of_rows_image, _number_of_cols_image, _parameters->minimum_projection_tracking_distance_pixels);
 
   //ds configure epipolar search ranges (minimum 0)
   _maximum_epipolar_search_offset_pixels = _parameters->maximum_epipolar_search_offset_pixels;
@@ -67,19 +83,81 @@ void StereoFramePointGenerator::initialize(Frame* frame_, const bool& extract_fe
   if (extract_features_) {
 
     //ds detect new features to generate frame points from (fixed thresholds)
-    detectKeypoints(frame_->intensityImageLeft(), frame_->keypointsLeft());
-    detectKeypoints(frame_->intensityImageRight(), frame_->keypointsRight());
+    if (_parameters->enable_epipolar_right_detection) {
+
+      //ds the right image is only processed where left keypoints can be matched - the left keypoints are required first
+      //ds periodically the complete right image is processed, resynchronizing the right thresholds with the actual keypoint counts
+      _is_right_detection_partial = (_parameters->epipolar_right_full_detection_interval == 0 ||
+                                     _number_of_right_detections%_parameters->epipolar_right_full_detection_interval != 0);
+      ++_number_of_right_detections;
+      detectKeypoints(frame_->intensityImageLeft(), frame_->keypointsLeft());
+      _number_of_detected_keypoints = frame_->keypointsLeft().size();
+      if (_is_right_detection_partial) {
+        _computeRightDetectionArea(frame_);
+      }
+      detectKeypointsRight(frame_->intensityImageRight(), frame_->keypointsRight());
 
-    //ds adjust detector thresholds for next frame
-    adjustDetectorThresholds(); // 모자라거나, 많은 경우 이에 맞춰서 조절한 threshold로 변경
+      //ds each stream keeps its own thresholds
+      adjustDetectorThresholds();
+    } else {
+      if (_parameters->enable_parallel_stereo_extraction) {
 
-    //ds overwrite with average
-    _number_of_detected_keypoints = (frame_->keypointsLeft().size()+frame_->keypointsRight().size())/2.0; // 좌우측 개수의 평균으로 설정
+        //ds process both image streams concurrently - each stream adapts its own detector thresholds
+        CHRONOMETER_START(keypoint_detection)
+        _worker_pool->run(2, [this, &frame_](const Index& index_) {
+          if (index_ == 0) {
+            _feature_extractor_left.detectKeypoints(frame_->intensityImageLeft(), frame_->keypointsLeft());
+          } else {
+            _feature_extractor_right.detectKeypoints(frame_->intensityImageRight(), frame_->keypointsRight());
+          }
+        });
+        CHRONOMETER_STOP(keypoint_detection)
+      } else {
+        detectKeypoints(frame_->intensityImageLeft(), frame_->keypointsLeft());
+        detectKeypointsRight(frame_->intensityImageRight(), frame_->keypointsRight());
+      }
+
+      //ds adjust detector thresholds for next frame
+      adjustDetectorThresholds(); // 모자라거나, 많은 경우 이에 맞춰서 조절한 threshold로 변경
+
+      //ds overwrite with average
+      _number_of_detected_keypoints = (frame_->keypointsLeft().size()+frame_->keypointsRight().size())/2.0; // 좌우측 개수의 평균으로 설정
+    }
     frame_->_number_of_detected_keypoints = _number_of_detected_keypoints;
 
-    //ds extract descriptors for detected features
-    computeDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft(), frame_->descriptorsLeft());
-    computeDescriptors(frame_->intensityImageRight(), frame_->keypointsRight(), frame_->descriptorsRight());
+    //ds build the image pyramid for tracking in the next frame (and from the previous frame)
+    if (_parameters->enable_pyramid_tracking) {
+      _updateImagePyramid(frame_);
+    }
+
+    //ds extract descriptors for detected features (in lazy mode only the keypoints are prepared)
+    if (_parameters->enable_parallel_stereo_extraction) {
+      CHRONOMETER_START(descriptor_extraction)
+      _worker_pool->run(2, [this, &frame_](const Index& index_) {
+        if (index_ == 0) {
+          if (_feature_extractor_left.isLazy()) {
+            _feature_extractor_left.prepareLazyDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft());
+          } else {
+            _feature_extractor_left.computeDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft(), frame_->descriptorsLeft());
+          }
+        } else {
+          if (_feature_extractor_right.isLazy()) {
+            _feature_extractor_right.prepareLazyDescriptors(frame_->intensityImageRight(), frame_->keypointsRight());
+          } else {
+            _feature_extractor_right.computeDescriptors(frame_->intensityImageRight(), frame_->keypointsRight(), frame_->descriptorsRight());
+          }
+        }
+      });
+      CHRONOMETER_STOP(descriptor_extraction)
+    } else if (_feature_extractor_left.isLazy()) {
+      CHRONOMETER_START(descriptor_extraction)
+      _feature_extractor_left.prepareLazyDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft());
+      _feature_extractor_right.prepareLazyDescriptors(frame_->intensityImageRight(), frame_->keypointsRight());
+      CHRONOMETER_STOP(descriptor_extraction)
+    } else {
+      computeDescriptors(frame_->intensityImageLeft(), frame_->keypointsLeft(), frame_->descriptorsLeft());
+      computeDescriptorsRight(frame_->intensityImageRight(), frame_->keypointsRight(), frame_->descriptorsRight());
+    }
     LOG_DEBUG(std::cerr << "StereoFramePointGenerator::initialize|extracted features L: " << frame_->keypointsLeft().size()
                         << " R: " << frame_->keypointsRight().size() << std::endl)
 
@@ -96,9 +174,80 @@ void StereoFramePointGenerator::initialize(Frame* frame_, const bool& extract_fe
     }
   }
 
+  //ds if the matchers already hold the features of this frame (e.g. repeated tracking attempt) we only reset the matches
+  //ds this keeps all descriptors, including the ones computed on demand in a previous attempt
+  if (!extract_features_ && _is_matcher_frame_valid && _matcher_frame_identifier == frame_->identifier()) {
+    _feature_matcher_left.resetMatches();
+    _feature_matcher_right.resetMatches();
+    return;
+  }
+  _matcher_frame_identifier = frame_->identifier();
+  _is_matcher_frame_valid   = true;
+
+  //ds cached track searches refer to the features of the previous call
+  _are_track_region_caches_valid = false;
+
   //ds initialize matchers for left and right frame
-  _feature_matcher_left.setFeatures(frame_->keypointsLeft(), frame_->descriptorsLeft());
-  _feature_matcher_right.setFeatures(frame_->keypointsRight(), frame_->descriptorsRight());
+  //ds in lazy mode descriptors are computed on demand during tracking and stereo matching
+  if (_feature_extractor_left.isLazy()) {
+    _feature_matcher_left.setFeatures(frame_->keypointsLeft(), _feature_extractor_left.lazyDescriptorExtractor());
+    _feature_matcher_right.setFeatures(frame_->keypointsRight(), _feature_extractor_right.lazyDescriptorExtractor());
+  } else {
+    _feature_matcher_left.setFeatures(frame_->keypointsLeft(), frame_->descriptorsLeft());
+    _feature_matcher_right.setFeatures(frame_->keypointsRight(), frame_->descriptorsRight());
+  }
+}
+
+void StereoFramePointGenerator::detectKeypointsRight(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_) {
+  CHRONOMETER_START(keypoint_detection)
+  if (_parameters->enable_epipolar_right_detection && _is_right_detection_partial) {
+    _feature_extractor_right.detectKeypoints(intensity_image_, keypoints_, _col_end_per_row_right);
+  } else {
+    _feature_extractor_right.detectKeypoints(intensity_image_, keypoints_);
+  }
+  CHRONOMETER_STOP(keypoint_detection)
+}
+
+void StereoFramePointGenerator::computeDescriptorsRight(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_) {
+  CHRONOMETER_START(descriptor_extraction)
+  _feature_extractor_right.computeDescriptors(intensity_image_, keypoints_, descriptors_);
+  CHRONOMETER_STOP(descriptor_extraction)
+}
+
+void StereoFramePointGenerator::describeKeypointsRight(const cv::Mat& intensity_image_,
+                                                       std::vector<cv::KeyPoint>& keypoints_,
+                                                       DescriptorVector& descriptors_,
+                                                       std::vector<uint8_t>& is_described_) {
+  _feature_extractor_right.describeKeypoints(intensity_image_, keypoints_, descriptors_, is_described_);
+}
+
+void StereoFramePointGenerator::_computeRightDetectionArea(Frame* frame_) {
+  _col_end_per_row_right.assign(_number_of_rows_image, 0);
+
+  //ds maximum epipolar offset searched in this frame: by stereo matching or by tracking of a previous point
+  int32_t epipolar_offset_maximum = _maximum_epipolar_search_offset_pixels;
+  if (frame_->previous()) {
+    for (const FramePoint* point_previous: frame_->previous()->points()) {
+      epipolar_offset_maximum = std::max(epipolar_offset_maximum, std::abs(point_previous->epipolarOffset()));
+    }
+  }
+
+  //ds a right keypoint can only be matched by a left keypoint on a nearby row with equal or larger column
+  //ds the rows are extended by one, as the corrected right projection used in tracking can be rounded up by one row
+  for (const cv::KeyPoint& keypoint_left: frame_->keypointsLeft()) {
+    const int32_t row_left  = keypoint_left.pt.y;
+    const int32_t col_end   = static_cast<int32_t>(keypoint_left.pt.x)+1;
+    const int32_t row_begin = std::max(row_left-epipolar_offset_maximum, 0);
+    const int32_t row_end   = std::min(row_left+epipolar_offset_maximum+2, _number_of_rows_image);
+    for (int32_t row = row_begin; row < row_end; ++row) {
+      _col_end_per_row_right[row] = std::max(_col_end_per_row_right[row], col_end);
+    }
+  }
+}
+
+void StereoFramePointGenerator::adjustDetectorThresholds() {
+  _feature_extractor_left.adjustDetectorThresholds();
+  _feature_extractor_right.adjustDetectorThresholds();
 }
 
 void StereoFramePointGenerator::track(Frame* frame_,
@@ -120,126 +269,128 @@ void StereoFramePointGenerator::track(Frame* frame_,
   //ds store points for which we couldn't find a track candidate
   previous_framepoints_without_tracks_.resize(framepoints_previous.size());
 
-  //ds tracked and triangulated features (to not consider them in the exhaustive stereo matching)
-  std::set<uint32_t> matched_indices_left;
-  std::set<uint32_t> matched_indices_right;
   Count number_of_points       = 0;
   Count number_of_points_lost  = 0;
   _number_of_tracked_landmarks = 0;
+  const Count number_of_points_previous = framepoints_previous.size();
 
-  //ds for each previous point
-  for (FramePoint* point_previous: framepoints_previous) {
-
-    //ds transform the point into the current camera frame
-    const Vector3 point_in_camera_left_prediction(camera_left_previous_in_current_*point_previous->cameraCoordinatesLeft());
+  //ds project all previous points into the current left image plane in one pass
+  _points_in_camera_left_previous.resize(3, number_of_points_previous);
+  for (Index u = 0; u < number_of_points_previous; ++u) {
+    _points_in_camera_left_previous.col(u) = framepoints_previous[u]->cameraCoordinatesLeft();
+  }
+  _points_in_image_left.noalias() = (camera_calibration_matrix*camera_left_previous_in_current_.linear())*_points_in_camera_left_previous;
+  _points_in_image_left.colwise() += camera_calibration_matrix*camera_left_previous_in_current_.translation();
 
-    //ds project the point into the current left image plane
-    const Vector3 point_in_image_left(camera_calibration_matrix*point_in_camera_left_prediction);
-    const int32_t col_projection_left = point_in_image_left.x()/point_in_image_left.z();
-    const int32_t row_projection_left = point_in_image_left.y()/point_in_image_left.z();
+  //ds derive a search window for each point from the motion uncertainty (not while tracking by appearance)
+  const bool use_adaptive_windows = _parameters->enable_adaptive_tracking_windows && !track_by_appearance_;
+  if (use_adaptive_windows) {
+    _computeTrackingDistances();
+  }
 
-    //ds skip point if not in image plane
-    if (col_projection_left < 0 || col_projection_left > _number_of_cols_image ||
-        row_projection_left < 0 || row_projection_left > _number_of_rows_image) {
-      continue;
+  //ds refine the predictions coarse to fine in the image pyramids if available for both frames
+  const bool match_in_parallel = _parameters->enable_parallel_tracking && number_of_points_previous > 1;
+  const bool refine_in_pyramid = _parameters->enable_pyramid_tracking && _isImagePyramidAvailable(frame_previous_, frame_);
+  constexpr Count number_of_points_per_job = 64;
+  _is_prediction_refined.assign(number_of_points_previous, 0);
+  if (refine_in_pyramid) {
+    _points_in_image_left_refined.resize(3, number_of_points_previous);
+    auto refinePredictions = [&](const Index& index_begin_, const Index& index_end_) {
+      for (Index u = index_begin_; u < index_end_; ++u) {
+        const real depth = _points_in_image_left(2, u);
+        if (depth <= 0) {
+          continue;
+        }
+        cv::Point2f position_predicted(_points_in_image_left(0, u)/depth, _points_in_image_left(1, u)/depth);
+        if (_refinePredictionInPyramid(framepoints_previous[u]->keypointLeft().pt, position_predicted)) {
+          _points_in_image_left_refined.col(u) = Vector3(position_predicted.x*depth, position_predicted.y*depth, depth);
+          _is_prediction_refined[u] = 1;
+        }
+      }
+    };
+    if (match_in_parallel) {
+      _worker_pool->run((number_of_points_previous+number_of_points_per_job-1)/number_of_points_per_job, [&](const Index& index_job_) {
+        refinePredictions(index_job_*number_of_points_per_job, std::min((index_job_+1)*number_of_points_per_job, number_of_points_previous));
+      });
+    } else {
+      refinePredictions(0, number_of_points_previous);
     }
+  }
 
-    //ds TRACKING obtain matching feature in left image (if any)
-    real descriptor_distance_best = _parameters->matching_distance_tracking_threshold;
-
-    //ds define search region (rectangular ROI)
-    int32_t row_start_point = std::max(row_projection_left-_projection_tracking_distance_pixels, 0);
-    int32_t row_end_point   = std::min(row_projection_left+_projection_tracking_distance_pixels+1, _number_of_rows_image);
-    int32_t col_start_point = std::max(col_projection_left-_projection_tracking_distance_pixels, 0);
-    int32_t col_end_point   = std::min(col_projection_left+_projection_tracking_distance_pixels+1, _number_of_cols_image);
-
-    //ds find the best match for the previous left feature (i.e. track it)
-    IntensityFeature* feature_left = _feature_matcher_left.getMatchingFeatureInRectangularRegion(row_projection_left,
-                                                                                                 col_projection_left,
-                                                                                                 point_previous->descriptorLeft(),
-                                                                                                 row_start_point,
-                                                                                                 row_end_point,
-                                                                                                 col_start_point,
-                                                                                                 col_end_point,
-                                                                                                 _parameters->matching_distance_tracking_threshold,
-                                                                                                 track_by_appearance_,
-                                                                                                 descriptor_distance_best);
-
-    //ds if we found a match
-    if (feature_left) {
-
-      //ds compute projection offset (i.e. prediction error > optical flow)
-      const cv::Point2f projection_error(col_projection_left-feature_left->keypoint.pt.x, row_projection_left-feature_left->keypoint.pt.y);
-
-      //ds project point into the right image - correcting by the prediction error
-      const Vector3 point_in_image_right(point_in_image_left+_baseline);
-      const int32_t col_projection_right_corrected = point_in_image_right.x()/point_in_image_right.z()-projection_error.x;
-      const int32_t row_projection_right_corrected = point_in_image_right.y()/point_in_image_right.z()-projection_error.y;
+  //ds descriptor distances of previous attempts for the same frames are reused (e.g. in a recursive registration)
+  //ds a new search window only compares the features outside of the window already searched for a point
+  if (!_are_track_region_caches_valid ||
+      _track_region_caches_frame_identifier          != frame_->identifier() ||
+      _track_region_caches_frame_identifier_previous != frame_previous_->identifier() ||
+      _track_region_caches.size()                    != number_of_points_previous) {
+    _track_region_caches.resize(number_of_points_previous);
+    for (IntensityFeatureMatcher::RegionCache& cache: _track_region_caches) {
+      cache.clear();
+    }
+    _track_region_caches_frame_identifier          = frame_->identifier();
+    _track_region_caches_frame_identifier_previous = frame_previous_->identifier();
+    _are_track_region_caches_valid                 = true;
+  }
 
-      //ds skip point if not in image plane
-      if (col_projection_right_corrected < 0 || col_projection_right_corrected > _number_of_cols_image ||
-          row_projection_right_corrected < 0 || row_projection_right_corrected > _number_of_rows_image) {
-        continue;
+  //ds search track candidates for all points in parallel if desired - features are not claimed in this stage
+  _track_matches.resize(number_of_points_previous);
+  if (match_in_parallel) {
+    _worker_pool->run((number_of_points_previous+number_of_points_per_job-1)/number_of_points_per_job, [&](const Index& index_job_) {
+      const Index index_end = std::min((index_job_+1)*number_of_points_per_job, number_of_points_previous);
+      for (Index u = index_job_*number_of_points_per_job; u < index_end; ++u) {
+        _searchTrack(framepoints_previous[u], u, track_by_appearance_, _track_region_caches[u], _track_matches[u]);
       }
+    });
+  }
 
-      //ds TRIANGULATION: obtain matching feature in right image (if any)
-      //ds we reduce the vertical matching space to the epipolar range - we search only to the left of the measure left camera coordinate
-      const int32_t epipolar_offset_previous = std::fabs(point_previous->epipolarOffset());
-      row_start_point = std::max(row_projection_right_corrected-epipolar_offset_previous, 0);
-      row_end_point   = std::min(row_projection_right_corrected+epipolar_offset_previous+1, _number_of_rows_image);
-      col_start_point = std::max(col_projection_right_corrected-_projection_tracking_distance_pixels, 0);
-      col_end_point   = std::min(col_projection_right_corrected+_projection_tracking_distance_pixels+1, feature_left->col);
-
-      //ds we might increase the matching tolerance (maximum_matching_distance_triangulation) since we have a strong prior on location
-      IntensityFeature* feature_right = _feature_matcher_right.getMatchingFeatureInRectangularRegion(row_projection_right_corrected,
-                                                                                                     col_projection_right_corrected,
-                                                                                                     feature_left->descriptor,
-                                                                                                     row_start_point,
-                                                                                                     row_end_point,
-                                                                                                     col_start_point,
-                                                                                                     col_end_point,
-                                                                                                     _current_maximum_descriptor_distance_triangulation,
-                                                                                                     true,
-                                                                                                     descriptor_distance_best);
-
-      //ds if we found a match
-      if (feature_right) {
-        assert(feature_left->col >= feature_right->col);
-
-//        //ds skip feature if descriptor distance to previous is violated
-//        if (cv::norm(feature_right->descriptor, point_previous->descriptorRight(), SRRG_PROSLAM_DESCRIPTOR_NORM) > _parameters->matching_distance_tracking_threshold) {
-//          continue;
-//        }
+  //ds for each previous point (in order) - claim features
+  for (Index u = 0; u < number_of_points_previous; ++u) {
+    FramePoint* point_previous = framepoints_previous[u];
+    TrackMatch& match          = _track_matches[u];
+
+    //ds the candidate is identical to a sequential search if none of its features has been claimed by a preceding point
+    //ds otherwise (or if no candidate has been computed yet) we search again on the remaining features
+    if (!match_in_parallel ||
+        (match.feature_left && _feature_matcher_left.isMatched(match.feature_left)) ||
+        (match.feature_right && _feature_matcher_right.isMatched(match.feature_right))) {
+      _searchTrack(point_previous, u, track_by_appearance_, _track_region_caches[u], match);
+    }
 
-        //ds skip points with insufficient stereo disparity
-        if (feature_left->col-feature_right->col < _parameters->minimum_disparity_pixels) {
-          continue;
-        }
+    //ds if we found a match
+    if (match.feature_right) {
+      IntensityFeature* feature_left  = match.feature_left;
+      IntensityFeature* feature_right = match.feature_right;
+      assert(feature_left->col >= feature_right->col);
+
+      //ds skip points with insufficient stereo disparity
+      if (feature_left->col-feature_right->col >= _parameters->minimum_disparity_pixels) {
 
-        //ds create a stereo match
+        //ds create a stereo match (both features have been compared, hence their descriptors are available)
+        assert(_feature_matcher_left.isDescribed(feature_left) && _feature_matcher_right.isDescribed(feature_right));
         FramePoint* framepoint = frame_->createFramepoint(feature_left,
                                                           feature_right,
                                                           getPointInLeftCamera(feature_left->keypoint.pt, feature_right->keypoint.pt),
                                                           point_previous);
         framepoint->setEpipolarOffset(feature_right->row-feature_left->row);
-        framepoint->setDescriptorDistanceTriangulation(descriptor_distance_best);
+        framepoint->setDescriptorDistanceTriangulation(match.descriptor_distance);
 
         //ds VSUALIZATION ONLY
-        framepoint->setProjectionEstimateLeft(cv::Point2f(col_projection_left, row_projection_left));
+        const Vector3 point_in_image_right(_points_in_image_left.col(u)+_baseline);
+        framepoint->setProjectionEstimateLeft(cv::Point2f(match.col_projection_left, match.row_projection_left));
         framepoint->setProjectionEstimateRight(cv::Point2f(point_in_image_right.x()/point_in_image_right.z(), point_in_image_right.y()/point_in_image_right.z()));
-        framepoint->setProjectionEstimateRightCorrected(cv::Point2f(col_projection_right_corrected, row_projection_right_corrected));
+        framepoint->setProjectionEstimateRightCorrected(cv::Point2f(match.col_projection_right_corrected, match.row_projection_right_corrected));
 
         //ds store and move to next slot
         framepoints[number_of_points] = framepoint;
         ++number_of_points;
 
         //ds block matching in exhaustive matching (later)
-        matched_indices_left.insert(feature_left->index_in_vector);
-        matched_indices_right.insert(feature_right->index_in_vector);
+        _feature_matcher_left.markAsMatched(feature_left);
+        _feature_matcher_right.markAsMatched(feature_right);
 
-        //ds remove feature from lattices
-        _feature_matcher_left.feature_lattice[feature_left->row][feature_left->col]    = nullptr;
-        _feature_matcher_right.feature_lattice[feature_right->row][feature_right->col] = nullptr;
+        //ds remove features from the search grids
+        _feature_matcher_left.removeFromGrid(feature_left);
+        _feature_matcher_right.removeFromGrid(feature_right);
 
         if (framepoint->landmark()) {
           ++_number_of_tracked_landmarks;
@@ -256,15 +407,173 @@ void StereoFramePointGenerator::track(Frame* frame_,
   framepoints.resize(number_of_points);
   previous_framepoints_without_tracks_.resize(number_of_points_lost);
 
-  //ds remove matched indices from candidate pools
-  _feature_matcher_left.prune(matched_indices_left);
-  _feature_matcher_right.prune(matched_indices_right);
+  //ds remove matched features from candidate pools
+  _feature_matcher_left.prune();
+  _feature_matcher_right.prune();
   LOG_DEBUG(std::cerr << "StereoFramePointGenerator::track|tracked and triangulated points: " << number_of_points
                       << "/" << framepoints_previous.size() << " (landmarks: " << _number_of_tracked_landmarks << ")" << std::endl)
   LOG_DEBUG(std::cerr << "StereoFramePointGenerator::track|lost points: " << number_of_points_lost
                       << "/" << framepoints_previous.size() << std::endl)
 }
 
+void StereoFramePointGenerator::_searchTrack(const FramePoint* point_previous_,
+                                             const Index& index_,
+                                             const bool& track_by_appearance_,
+                                             IntensityFeatureMatcher::RegionCache& cache_,
+                                             TrackMatch& match_) const {
+
+  //ds a refined prediction is searched in a small window, we fall back to the complete window if nothing is found
+  if (_is_prediction_refined[index_]) {
+    _matchTrack(point_previous_,
+                _points_in_image_left_refined.col(index_),
+                track_by_appearance_,
+                _parameters->minimum_projection_tracking_distance_pixels,
+                _parameters->minimum_projection_tracking_distance_pixels,
+                cache_,
+                match_);
+    if (match_.feature_left) {
+      return;
+    }
+  }
+  if (_parameters->enable_adaptive_tracking_windows && !track_by_appearance_) {
+    _matchTrack(point_previous_,
+                _points_in_image_left.col(index_),
+                track_by_appearance_,
+                _tracking_distances_pixels(0, index_),
+                _tracking_distances_pixels(1, index_),
+                cache_,
+                match_);
+  } else {
+    _matchTrack(point_previous_,
+                _points_in_image_left.col(index_),
+                track_by_appearance_,
+                _projection_tracking_distance_pixels,
+                _projection_tracking_distance_pixels,
+                cache_,
+                match_);
+  }
+}
+
+void StereoFramePointGenerator::_computeTrackingDistances() {
+  const Count number_of_points = _points_in_image_left.cols();
+  _tracking_distances_pixels.resize(2, number_of_points);
+  const Matrix3& camera_calibration_matrix = _camera_left->cameraMatrix();
+  const real f_x = camera_calibration_matrix(0, 0);
+  const real f_y = camera_calibration_matrix(1, 1);
+  const real c_x = camera_calibration_matrix(0, 2);
+  const real c_y = camera_calibration_matrix(1, 2);
+  const real sigma_translation = _parameters->motion_uncertainty_translation_meters;
+  const real sigma_rotation    = _parameters->motion_uncertainty_rotation_radians;
+  const real distance_minimum  = _parameters->minimum_adaptive_tracking_distance_pixels;
+  const real distance_maximum  = _parameters->maximum_projection_tracking_distance_pixels;
+
+  //ds the tracking distance maintained by the tracker (tunnel vision) scales the uncertainty
+  const real uncertainty_scale = static_cast<real>(_projection_tracking_distance_pixels)/_parameters->minimum_projection_tracking_distance_pixels;
+
+  for (Index u = 0; u < number_of_points; ++u) {
+    const real depth = _points_in_image_left(2, u);
+    if (depth <= 0) {
+      _tracking_distances_pixels.col(u).setConstant(distance_maximum);
+      continue;
+    }
+    const real col = _points_in_image_left(0, u)/depth;
+    const real row = _points_in_image_left(1, u)/depth;
+
+    //ds first order image displacement: rotation errors are depth independent, translation errors scale with inverse depth
+    //ds (lateral translation: f/depth, translation along the optical axis: distance to the principal point/depth)
+    const real row_distance = uncertainty_scale*(f_y*sigma_rotation+(f_y+std::fabs(row-c_y))*sigma_translation/depth);
+    const real col_distance = uncertainty_scale*(f_x*sigma_rotation+(f_x+std::fabs(col-c_x))*sigma_translation/depth);
+    _tracking_distances_pixels(0, u) = std::ceil(std::min(std::max(row_distance, distance_minimum), distance_maximum));
+    _tracking_distances_pixels(1, u) = std::ceil(std::min(std::max(col_distance, distance_minimum), distance_maximum));
+  }
+}
+
+void StereoFramePointGenerator::_matchTrack(const FramePoint* point_previous_,
+                                            const Vector3& point_in_image_left_,
+                                            const bool& track_by_appearance_,
+                                            const int32_t& row_tracking_distance_pixels_,
+                                            const int32_t& col_tracking_distance_pixels_,
+                                            IntensityFeatureMatcher::RegionCache& cache_,
+                                            TrackMatch& match_) const {
+  match_.feature_left  = nullptr;
+  match_.feature_right = nullptr;
+  match_.col_projection_left = point_in_image_left_.x()/point_in_image_left_.z();
+  match_.row_projection_left = point_in_image_left_.y()/point_in_image_left_.z();
+  const int32_t& col_projection_left = match_.col_projection_left;
+  const int32_t& row_projection_left = match_.row_projection_left;
+
+  //ds skip point if not in image plane
+  if (col_projection_left < 0 || col_projection_left > _number_of_cols_image ||
+      row_projection_left < 0 || row_projection_left > _number_of_rows_image) {
+    return;
+  }
+
+  //ds TRACKING obtain matching feature in left image (if any)
+  real descriptor_distance_best = _parameters->matching_distance_tracking_threshold;
+
+  //ds define search region (rectangular ROI)
+  int32_t row_start_point = std::max(row_projection_left-row_tracking_distance_pixels_, 0);
+  int32_t row_end_point   = std::min(row_projection_left+row_tracking_distance_pixels_+1, _number_of_rows_image);
+  int32_t col_start_point = std::max(col_projection_left-col_tracking_distance_pixels_, 0);
+  int32_t col_end_point   = std::min(col_projection_left+col_tracking_distance_pixels_+1, _number_of_cols_image);
+
+  //ds find the best match for the previous left feature (i.e. track it)
+  IntensityFeature* feature_left = _feature_matcher_left.getMatchingFeatureInRectangularRegion(row_projection_left,
+                                                                                               col_projection_left,
+                                                                                               point_previous_->descriptorLeft(),
+                                                                                               row_start_point,
+                                                                                               row_end_point,
+                                                                                               col_start_point,
+                                                                                               col_end_point,
+                                                                                               _parameters->matching_distance_tracking_threshold,
+                                                                                               track_by_appearance_,
+                                                                                               descriptor_distance_best,
+                                                                                               cache_);
+
+  //ds if we found no match
+  if (!feature_left) {
+    return;
+  }
+  match_.feature_left = feature_left;
+
+  //ds compute projection offset (i.e. prediction error > optical flow)
+  const cv::Point2f projection_error(col_projection_left-feature_left->keypoint.pt.x, row_projection_left-feature_left->keypoint.pt.y);
+
+  //ds project point into the right image - correcting by the prediction error
+  const Vector3 point_in_image_right(point_in_image_left_+_baseline);
+  match_.col_projection_right_corrected = point_in_image_right.x()/point_in_image_right.z()-projection_error.x;
+  match_.row_projection_right_corrected = point_in_image_right.y()/point_in_image_right.z()-projection_error.y;
+  const int32_t& col_projection_right_corrected = match_.col_projection_right_corrected;
+  const int32_t& row_projection_right_corrected = match_.row_projection_right_corrected;
+
+  //ds skip point if not in image plane
+  if (col_projection_right_corrected < 0 || col_projection_right_corrected > _number_of_cols_image ||
+      row_projection_right_corrected < 0 || row_projection_right_corrected > _number_of_rows_image) {
+    return;
+  }
+
+  //ds TRIANGULATION: obtain matching feature in right image (if any)
+  //ds we reduce the vertical matching space to the epipolar range - we search only to the left of the measure left camera coordinate
+  const int32_t epipolar_offset_previous = std::fabs(point_previous_->epipolarOffset());
+  row_start_point = std::max(row_projection_right_corrected-epipolar_offset_previous, 0);
+  row_end_point   = std::min(row_projection_right_corrected+epipolar_offset_previous+1, _number_of_rows_image);
+  col_start_point = std::max(col_projection_right_corrected-col_tracking_distance_pixels_, 0);
+  col_end_point   = std::min(col_projection_right_corrected+col_tracking_distance_pixels_+1, feature_left->col);
+
+  //ds we might increase the matching tolerance (maximum_matching_distance_triangulation) since we have a strong prior on location
+  match_.feature_right = _feature_matcher_right.getMatchingFeatureInRectangularRegion(row_projection_right_corrected,
+                                                                                      col_projection_right_corrected,
+                                                                                      _feature_matcher_left.descriptor(feature_left),
+                                                                                      row_start_point,
+                                                                                      row_end_point,
+                                                                                      col_start_point,
+                                                                                      col_end_point,
+                                                                                      _current_maximum_descriptor_distance_triangulation,
+                                                                                      true,
+                                                                                      descriptor_distance_best);
+  match_.descriptor_distance = descriptor_distance_best;
+}
+
 const PointCoordinates StereoFramePointGenerator::getPointInLeftCamera(const cv::Point2f& image_coordinates_left_, const cv::Point2f& image_coordinates_right_) const {
   assert(image_coordinates_left_.x >= image_coordinates_right_.x);
   assert(image_coordinates_left_.x-image_coordinates_right_.x >= _parameters->minimum_disparity_pixels);
@@ -290,168 +599,95 @@ void StereoFramePointGenerator::compute(Frame* frame_) {
   FramePointPointerVector& framepoints(frame_->points());
   const Count number_of_points_tracked = framepoints.size();
 
-  //ds store already present points for optional binning
+  //ds bins of already present (tracked) points are not available for new points
   if (_parameters->enable_keypoint_binning) {
+    _bin_map_left.assign(_number_of_rows_bin*_number_of_cols_bin, _bin_free);
     for (FramePoint* point: frame_->points()) {
-      const Index row_bin = std::rint(static_cast<real>(point->row)/_parameters->bin_size_pixels);
-      const Index col_bin = std::rint(static_cast<real>(point->col)/_parameters->bin_size_pixels);
-      _bin_map_left[row_bin][col_bin] = point;
+      const Index row_bin = std::min(static_cast<Index>(std::rint(static_cast<real>(point->row)/_parameters->bin_size_pixels)), _number_of_rows_bin-1);
+      const Index col_bin = std::min(static_cast<Index>(std::rint(static_cast<real>(point->col)/_parameters->bin_size_pixels)), _number_of_cols_bin-1);
+      _bin_map_left[row_bin*_number_of_cols_bin+col_bin] = _bin_occupied;
     }
   }
 
-  //ds prepare for fast stereo matching
+  //ds prepare for fast stereo matching: features of a row can be accessed directly for any epipolar offset
   _feature_matcher_left.sortFeatureVector();
   _feature_matcher_right.sortFeatureVector();
   IntensityFeaturePointerVector& features_left(_feature_matcher_left.feature_vector);
   IntensityFeaturePointerVector& features_right(_feature_matcher_right.feature_vector);
+  _buildRowTable(features_left, _row_begins_left);
+  _buildRowTable(features_right, _row_begins_right);
 
-  //ds new framepoints - optionally filtered in a consecutive binning
-  FramePointPointerVector framepoints_new(features_left.size());
-  Count number_of_new_points = 0;
+  //ds new framepoint candidates - optionally filtered in a consecutive binning, framepoints are only created for surviving candidates
+  _stereo_candidates.clear();
 
   //ds start stereo matching for all epipolar offsets
   for (const int32_t& epipolar_offset: _epipolar_search_offsets_pixel) {
 
-    //ds matched features (to not consider them for the next offset search)
-    std::set<uint32_t> matched_indices_left;
-    std::set<uint32_t> matched_indices_right;
-
-    //ds running variable
-    uint32_t index_R = 0;
-
-    //ds loop over all left keypoints
-    for (uint32_t index_L = 0; index_L < features_left.size(); index_L++) {
-
-      //ds if there are no more points on the right to match against - stop
-      if (index_R == features_right.size()) {break;}
-
-      //ds the right keypoints are on an lower row - skip left
-      while (features_left[index_L]->row < features_right[index_R]->row+epipolar_offset) {
-        index_L++; if (index_L == features_left.size()) {break;}
-      }
-      if (index_L == features_left.size()) {break;}
-      IntensityFeature* feature_left = features_left[index_L];
-
-      //ds the right keypoints are on an upper row - skip right
-      while (feature_left->row > features_right[index_R]->row+epipolar_offset) {
-        index_R++; if (index_R == features_right.size()) {break;}
-      }
-      if (index_R == features_right.size()) {break;}
-
-      //ds search bookkeeping
-      uint32_t index_search_R       = index_R;
-      real descriptor_distance_best = _current_maximum_descriptor_distance_triangulation;
-      uint32_t index_best_R         = 0;
-
-      //ds scan epipolar line for current keypoint at idx_L - exhaustive
-      while (feature_left->row == features_right[index_search_R]->row+epipolar_offset) {
-
-        //ds invalid disparity stop condition
-        if (feature_left->col-features_right[index_search_R]->col < 0) {break;}
+    //ds collect all matches on the current epipolar offset
+    _matchEpipolarOffset(features_left, features_right, epipolar_offset, _stereo_matches);
+
+    //ds register candidates in ascending left order
+    for (const StereoMatch& match: _stereo_matches) {
+      IntensityFeature* feature_left  = features_left[match.index_left];
+      IntensityFeature* feature_right = features_right[match.index_right];
+      const StereoCandidate candidate(feature_left, feature_right, match.descriptor_distance, epipolar_offset);
+
+      //ds store candidate for optional binning
+      if (_parameters->enable_keypoint_binning) {
+        const Index row_bin = std::min(static_cast<Index>(std::rint(static_cast<real>(feature_left->row)/_parameters->bin_size_pixels)), _number_of_rows_bin-1);
+        const Index col_bin = std::min(static_cast<Index>(std::rint(static_cast<real>(feature_left->col)/_parameters->bin_size_pixels)), _number_of_cols_bin-1);
+        int32_t& bin = _bin_map_left[row_bin*_number_of_cols_bin+col_bin];
+
+        //ds if there is already a new point in the bin, we prefer points with maximal disparity (= maximally accurate depth estimate)
+        if (bin >= 0) {
+          const StereoCandidate& candidate_in_bin = _stereo_candidates[bin];
+          if (candidate.disparity_pixels > candidate_in_bin.disparity_pixels &&
+              candidate.descriptor_distance <= candidate_in_bin.descriptor_distance) {
+
+            //ds overwrite the entry
+            bin = _stereo_candidates.size();
+          }
+        } else if (bin == _bin_free) {
 
-        //ds compute descriptor distance for the stereo match candidates
-        const real descriptor_distance = cv::norm(feature_left->descriptor, features_right[index_search_R]->descriptor, SRRG_PROSLAM_DESCRIPTOR_NORM);
-        if(descriptor_distance < descriptor_distance_best) {
-          descriptor_distance_best = descriptor_distance;
-          index_best_R             = index_search_R;
+          //ds add a new entry
+          bin = _stereo_candidates.size();
         }
-        index_search_R++; if (index_search_R == features_right.size()) {break;}
       }
+      _stereo_candidates.push_back(candidate);
 
-      //ds check if something was found
-      if (descriptor_distance_best < _current_maximum_descriptor_distance_triangulation) { // 왠지 Triangulation할 거 같음
-        IntensityFeature* feature_right = features_right[index_best_R];
-
-        //ds skip points with insufficient stereo disparity, 너무 멀리있는 경우
-        if (feature_left->col-feature_right->col < _parameters->minimum_disparity_pixels) {
-          continue;
-        }
-
-        //ds compute a new framepoint without track
-        FramePoint* framepoint = frame_->createFramepoint(feature_left,
-                                                          feature_right,
-                                                          getPointInLeftCamera(feature_left->keypoint.pt, feature_right->keypoint.pt));
-        framepoint->setEpipolarOffset(epipolar_offset);
-        framepoint->setDescriptorDistanceTriangulation(descriptor_distance_best);
-
-        //ds store point for optional binning
-        if (_parameters->enable_keypoint_binning) {
-          const Index row_bin = std::rint(static_cast<real>(feature_left->row)/_parameters->bin_size_pixels);
-          const Index col_bin = std::rint(static_cast<real>(feature_left->col)/_parameters->bin_size_pixels);
-
-          //ds if there is already a point in the bin
-          if (_bin_map_left[row_bin][col_bin]) {
-
-            //ds if the point in the bin is not tracked, we prefer points with maximal disparity (= maximally accurate depth estimate)
-            if (!_bin_map_left[row_bin][col_bin]->previous() &&
-                framepoint->disparityPixels() > _bin_map_left[row_bin][col_bin]->disparityPixels() &&
-                framepoint->descriptorDistanceTriangulation() <= _bin_map_left[row_bin][col_bin]->descriptorDistanceTriangulation()) {
-
-              //ds overwrite the entry
-              _bin_map_left[row_bin][col_bin] = framepoint;
-            }
-          } else {
-
-            //ds add a new entry
-            _bin_map_left[row_bin][col_bin] = framepoint;
-          }
-        }
-
-        //ds set point to buffer
-        framepoints_new[number_of_new_points] = framepoint;
-        ++number_of_new_points;
-
-        //ds block further matching against features_right[index_best_R] in a search on offset epipolar lines
-        matched_indices_left.insert(index_L);
-        matched_indices_right.insert(index_best_R);
-
-        //ds reduce search space (this eliminates all structurally conflicting matches)
-        index_R = index_best_R+1;
-      }
+      //ds block further matching against the right feature in a search on offset epipolar lines
+      _feature_matcher_left.markAsMatched(feature_left);
+      _feature_matcher_right.markAsMatched(feature_right);
     }
-
-    //ds remove matched indices from candidate pools
-    _feature_matcher_left.prune(matched_indices_left);
-    _feature_matcher_right.prune(matched_indices_right);
-    LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|epipolar offset: " << epipolar_offset << " number of unmatched features L: "
-              << features_left.size() << " R: " << features_right.size() << std::endl)
+    LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|epipolar offset: " << epipolar_offset << " number of matches: " << _stereo_matches.size() << std::endl)
   }
-  framepoints_new.resize(number_of_new_points);
-  LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|number of new stereo points: " << number_of_new_points << std::endl)
+
+  //ds remove matched features from candidate pools
+  _feature_matcher_left.prune();
+  _feature_matcher_right.prune();
+  LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|number of new stereo points: " << _stereo_candidates.size() << std::endl)
 
   //ds update framepoints - checking for the available points to optionally disable binning in very sparse scenarios
-  const real available_point_ratio = static_cast<real>(number_of_points_tracked+framepoints_new.size())/_target_number_of_keypoints;
+  const real available_point_ratio = static_cast<real>(number_of_points_tracked+_stereo_candidates.size())/_target_number_of_keypoints;
   if (_parameters->enable_keypoint_binning && available_point_ratio > 0.1) {
 
-    //ds reserve space for the best case (all points can be added)
-    Count number_of_points_binned = number_of_points_tracked;
-    framepoints.resize(number_of_points_tracked+number_of_new_points);
-
-    //ds accumulate new points over bin grid
-    for (Index row = 0; row < _number_of_rows_bin; ++row) {
-      for (Index col = 0; col < _number_of_cols_bin; ++col) {
-        if (_bin_map_left[row][col] && !_bin_map_left[row][col]->previous()) {
-          framepoints[number_of_points_binned] = _bin_map_left[row][col];
-          ++number_of_points_binned;
-        }
-        _bin_map_left[row][col] = nullptr;
+    //ds create framepoints for the winning candidates over the bin grid
+    framepoints.reserve(number_of_points_tracked+_stereo_candidates.size());
+    for (const int32_t& bin: _bin_map_left) {
+      if (bin >= 0) {
+        framepoints.push_back(_createFramepoint(frame_, _stereo_candidates[bin]));
       }
     }
-    framepoints.resize(number_of_points_binned);
-    LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|number of new stereo points binned: " << number_of_points_binned-number_of_points_tracked << std::endl)
+    LOG_DEBUG(std::cerr << "StereoFramePointGenerator::compute|number of new stereo points binned: " << framepoints.size()-number_of_points_tracked << std::endl)
   } else {
 
-    //ds add all points to frame
-    framepoints.insert(framepoints.end(), framepoints_new.begin(), framepoints_new.end());
-
-    //ds clean up bins if skipped before
+    //ds create framepoints for all candidates
     if (_parameters->enable_keypoint_binning) {
       LOG_WARNING(std::cerr << "StereoFramePointGenerator::compute|skipped binning due to low point density: " << available_point_ratio << std::endl)
-      for (Index row = 0; row < _number_of_rows_bin; ++row) {
-        for (Index col = 0; col < _number_of_cols_bin; ++col) {
-          _bin_map_left[row][col] = nullptr;
-        }
-      }
+    }
+    framepoints.reserve(number_of_points_tracked+_stereo_candidates.size());
+    for (const StereoCandidate& candidate: _stereo_candidates) {
+      framepoints.push_back(_createFramepoint(frame_, candidate));
     }
   }
 
@@ -483,4 +719,128 @@ void StereoFramePointGenerator::compute(Frame* frame_) {
 //    _epipolar_search_offsets_pixel.pop_back();
 //  }
 }
+
+FramePoint* StereoFramePointGenerator::_createFramepoint(Frame* frame_, const StereoCandidate& candidate_) const {
+  assert(_feature_matcher_left.isDescribed(candidate_.feature_left) && _feature_matcher_right.isDescribed(candidate_.feature_right));
+  FramePoint* framepoint = frame_->createFramepoint(candidate_.feature_left,
+                                                    candidate_.feature_right,
+                                                    getPointInLeftCamera(candidate_.feature_left->keypoint.pt, candidate_.feature_right->keypoint.pt));
+  framepoint->setEpipolarOffset(candidate_.epipolar_offset);
+  framepoint->setDescriptorDistanceTriangulation(candidate_.descriptor_distance);
+  return framepoint;
+}
+
+void StereoFramePointGenerator::_buildRowTable(const IntensityFeaturePointerVector& features_, std::vector<uint32_t>& row_begins_) const {
+  row_begins_.resize(_number_of_rows_image+1);
+  uint32_t index = 0;
+  for (int32_t row = 0; row <= _number_of_rows_image; ++row) {
+    while (index < features_.size() && features_[index]->row < row) {
+      ++index;
+    }
+    row_begins_[row] = index;
+  }
+  assert(index == features_.size());
+}
+
+void StereoFramePointGenerator::_matchEpipolarOffset(const IntensityFeaturePointerVector& features_left_,
+                                                     const IntensityFeaturePointerVector& features_right_,
+                                                     const int32_t& epipolar_offset_,
+                                                     StereoMatchVector& matches_) {
+  matches_.clear();
+  const uint32_t number_of_features_left = features_left_.size();
+
+  //ds sequential matching in a single pass
+  if (!_parameters->enable_parallel_stereo_matching || number_of_features_left < 2) {
+    _matchEpipolarRows(features_left_, features_right_, epipolar_offset_, 0, _number_of_rows_image, matches_);
+    return;
+  }
+
+  //ds split the image rows into bands with similar numbers of left features (more bands than threads for load balancing)
+  const uint32_t number_of_bands = std::min(static_cast<uint32_t>(4*_worker_pool->numberOfThreads()), number_of_features_left);
+  _band_row_begins.clear();
+  _band_row_begins.push_back(0);
+  for (uint32_t u = 1; u < number_of_bands; ++u) {
+    const int32_t row_begin = features_left_[static_cast<uint64_t>(u)*number_of_features_left/number_of_bands]->row;
+    if (row_begin > _band_row_begins.back()) {
+      _band_row_begins.push_back(row_begin);
+    }
+  }
+  _band_row_begins.push_back(_number_of_rows_image);
+
+  //ds match all bands independently
+  const uint32_t number_of_bands_effective = _band_row_begins.size()-1;
+  _stereo_matches_per_band.resize(number_of_bands_effective);
+  _worker_pool->run(number_of_bands_effective, [&](const Index& index_band_) {
+    _stereo_matches_per_band[index_band_].clear();
+    _matchEpipolarRows(features_left_, features_right_, epipolar_offset_,
+                       _band_row_begins[index_band_], _band_row_begins[index_band_+1], _stereo_matches_per_band[index_band_]);
+  });
+
+  //ds merge the bands in ascending left order
+  for (uint32_t u = 0; u < number_of_bands_effective; ++u) {
+    matches_.insert(matches_.end(), _stereo_matches_per_band[u].begin(), _stereo_matches_per_band[u].end());
+  }
+}
+
+void StereoFramePointGenerator::_matchEpipolarRows(const IntensityFeaturePointerVector& features_left_,
+                                                   const IntensityFeaturePointerVector& features_right_,
+                                                   const int32_t& epipolar_offset_,
+                                                   const int32_t& row_begin_,
+                                                   const int32_t& row_end_,
+                                                   StereoMatchVector& matches_) const {
+
+  //ds loop over all left rows that have a right row on the epipolar offset
+  const int32_t row_left_begin = std::max(row_begin_, epipolar_offset_);
+  const int32_t row_left_end   = std::min(row_end_, _number_of_rows_image+epipolar_offset_);
+  for (int32_t row_left = row_left_begin; row_left < row_left_end; ++row_left) {
+    const int32_t row_right = row_left-epipolar_offset_;
+
+    //ds running variable: right features of the epipolar line not yet blocked by a match on this line
+    uint32_t index_R           = _row_begins_right[row_right];
+    const uint32_t index_R_end = _row_begins_right[row_right+1];
+
+    //ds loop over all unmatched left keypoints of the row
+    for (uint32_t index_L = _row_begins_left[row_left]; index_L < _row_begins_left[row_left+1]; ++index_L) {
+
+      //ds if there are no more points on the right to match against - move to next row
+      if (index_R == index_R_end) {break;}
+      const IntensityFeature* feature_left = features_left_[index_L];
+      if (_feature_matcher_left.isMatched(feature_left)) {continue;}
+
+      //ds search bookkeeping
+      real descriptor_distance_best = _current_maximum_descriptor_distance_triangulation;
+      uint32_t index_best_R         = 0;
+
+      //ds scan epipolar line for current keypoint - exhaustive over the unmatched right features
+      for (uint32_t index_search_R = index_R; index_search_R < index_R_end; ++index_search_R) {
+        const IntensityFeature* feature_right = features_right_[index_search_R];
+        if (_feature_matcher_right.isMatched(feature_right)) {continue;}
+
+        //ds invalid disparity stop condition
+        if (feature_left->col-feature_right->col < 0) {break;}
+
+        //ds compute descriptor distance for the stereo match candidates
+        const real descriptor_distance = HammingDistance::compute(_feature_matcher_left.descriptor(feature_left),
+                                                                 _feature_matcher_right.descriptor(feature_right));
+        if(descriptor_distance < descriptor_distance_best) {
+          descriptor_distance_best = descriptor_distance;
+          index_best_R             = index_search_R;
+        }
+      }
+
+      //ds check if something was found
+      if (descriptor_distance_best < _current_maximum_descriptor_distance_triangulation) {
+
+        //ds skip points with insufficient stereo disparity
+        if (feature_left->col-features_right_[index_best_R]->col < _parameters->minimum_disparity_pixels) {
+          continue;
+        }
+        matches_.push_back(StereoMatch(index_L, index_best_R, descriptor_distance_best));
+
+        //ds reduce search space (this eliminates all structurally conflicting matches)
+        index_R = index_best_R+1;
+      }
+    }
+  }
+}
 }
@@ -15,6 +15,21 @@ public:
   //ds initializes the framepoint generator (e.g. detects keypoints and computes descriptors in the left and right camera image)
   virtual void initialize(Frame* frame_, const bool& extract_features_ = true);
 
+  //! @brief detects keypoints in the right image with the detectors of the right image stream
+  void detectKeypointsRight(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_);
+
+  //! @brief extracts descriptors in the right image with the extractor of the right image stream
+  void computeDescriptorsRight(const cv::Mat& intensity_image_, std::vector<cv::KeyPoint>& keypoints_, cv::Mat& descriptors_);
+
+  //! @brief computes descriptors for arbitrary keypoints in the current right image with the extractor of the right image stream
+  void describeKeypointsRight(const cv::Mat& intensity_image_,
+                              std::vector<cv::KeyPoint>& keypoints_,
+                              DescriptorVector& descriptors_,
+                              std::vector<uint8_t>& is_described_);
+
+  //! @brief adjusts detector thresholds of the left and right image stream (independently)
+  void adjustDetectorThresholds() override;
+
   //! @brief computes framepoints based on exhaustive, rigid stereo matching on multiple epipolar lines without prior
   //! @param[in, out] frame_ frame that will be filled with framepoints
   virtual void compute(Frame* frame_);
@@ -40,6 +55,125 @@ public:
   inline void setCameraRight(const Camera* camera_right_) {_camera_right = camera_right_;}
   const real& meanTriangulationSuccessRatio() const {return _mean_triangulation_success_ratio;}
 
+//ds helpers
+protected:
+
+  //! @brief stereo match on an epipolar line (indices refer to the row sorted feature vectors of the matchers)
+  struct StereoMatch {
+    StereoMatch(const uint32_t& index_left_,
+                const uint32_t& index_right_,
+                const real& descriptor_distance_): index_left(index_left_),
+                                                   index_right(index_right_),
+                                                   descriptor_distance(descriptor_distance_) {}
+    uint32_t index_left;
+    uint32_t index_right;
+    real descriptor_distance;
+  };
+  typedef std::vector<StereoMatch> StereoMatchVector;
+
+  //! @brief stereo match that has not been materialized as framepoint yet (only the bin winners are materialized)
+  struct StereoCandidate {
+    StereoCandidate(IntensityFeature* feature_left_,
+                    IntensityFeature* feature_right_,
+                    const real& descriptor_distance_,
+                    const int32_t& epipolar_offset_): feature_left(feature_left_),
+                                                      feature_right(feature_right_),
+                                                      descriptor_distance(descriptor_distance_),
+                                                      disparity_pixels(feature_left_->keypoint.pt.x-feature_right_->keypoint.pt.x),
+                                                      epipolar_offset(epipolar_offset_) {}
+    IntensityFeature* feature_left;
+    IntensityFeature* feature_right;
+    real descriptor_distance;
+    real disparity_pixels;
+    int32_t epipolar_offset;
+  };
+  typedef std::vector<StereoCandidate> StereoCandidateVector;
+
+  //! @brief bin map markers (values >= 0 are indices of the candidate occupying the bin)
+  static constexpr int32_t _bin_free     = -1;
+  static constexpr int32_t _bin_occupied = -2;
+
+  //! @brief creates a framepoint without track for a stereo candidate
+  FramePoint* _createFramepoint(Frame* frame_, const StereoCandidate& candidate_) const;
+
+  //! @brief computes the part of the right image in which keypoints can be matched by the left keypoints of the frame
+  //! @param[in] frame_ frame with detected left keypoints
+  void _computeRightDetectionArea(Frame* frame_);
+
+  //! @brief builds a row table for row sorted features: features of row r are in [row_begins_[r], row_begins_[r+1])
+  //! @param[in] features_ features sorted by row and column
+  //! @param[out] row_begins_ index of the first feature for each image row (number of image rows + 1 entries)
+  void _buildRowTable(const IntensityFeaturePointerVector& features_, std::vector<uint32_t>& row_begins_) const;
+
+  //! @brief collects all stereo matches on the given epipolar offset, optionally in parallel over horizontal bands of left rows
+  //! @brief features marked as matched (on previous offsets) are skipped
+  //! @param[in] features_left_ left features, sorted by row and column (indexed by _row_begins_left)
+  //! @param[in] features_right_ right features, sorted by row and column (indexed by _row_begins_right)
+  //! @param[in] epipolar_offset_ row offset between left and right features
+  //! @param[out] matches_ stereo matches in ascending left order
+  void _matchEpipolarOffset(const IntensityFeaturePointerVector& features_left_,
+                            const IntensityFeaturePointerVector& features_right_,
+                            const int32_t& epipolar_offset_,
+                            StereoMatchVector& matches_);
+
+  //! @brief exhaustive epipolar matching for a range of left rows (thread safe)
+  //! @brief each left row is matched only against its right row on the epipolar offset, hence rows are independent of each other
+  //! @param[in] features_left_ left features, sorted by row and column (indexed by _row_begins_left)
+  //! @param[in] features_right_ right features, sorted by row and column (indexed by _row_begins_right)
+  //! @param[in] epipolar_offset_ row offset between left and right features
+  //! @param[in] row_begin_ first left row of the range
+  //! @param[in] row_end_ end of the left row range (exclusive)
+  //! @param[out] matches_ stereo matches in ascending left order (appended)
+  void _matchEpipolarRows(const IntensityFeaturePointerVector& features_left_,
+                          const IntensityFeaturePointerVector& features_right_,
+                          const int32_t& epipolar_offset_,
+                          const int32_t& row_begin_,
+                          const int32_t& row_end_,
+                          StereoMatchVector& matches_) const;
+
+  //! @brief track candidate for a previous framepoint (features are not claimed until the candidate is accepted)
+  struct TrackMatch {
+    IntensityFeature* feature_left  = nullptr;
+    IntensityFeature* feature_right = nullptr;
+    real descriptor_distance        = 0;
+    int32_t col_projection_left            = 0;
+    int32_t row_projection_left            = 0;
+    int32_t col_projection_right_corrected = 0;
+    int32_t row_projection_right_corrected = 0;
+  };
+  typedef std::vector<TrackMatch> TrackMatchVector;
+
+  //! @brief searches the left and right feature grids for a track of a previous framepoint (thread safe, features are not claimed)
+  //! @param[in] point_previous_ previous framepoint to track
+  //! @param[in] point_in_image_left_ predicted (homogeneous) projection of the point into the current left image
+  //! @param[in] track_by_appearance_ left search criterion (appearance or projection distance)
+  //! @param[in] row_tracking_distance_pixels_ vertical half size of the left search window
+  //! @param[in] col_tracking_distance_pixels_ horizontal half size of the left and right search windows
+  //! @param[in,out] cache_ left descriptor distances of previous searches for this point
+  //! @param[out] match_ best left and right candidate (nullptr if not available)
+  void _matchTrack(const FramePoint* point_previous_,
+                   const Vector3& point_in_image_left_,
+                   const bool& track_by_appearance_,
+                   const int32_t& row_tracking_distance_pixels_,
+                   const int32_t& col_tracking_distance_pixels_,
+                   IntensityFeatureMatcher::RegionCache& cache_,
+                   TrackMatch& match_) const;
+
+  //! @brief computes the search window half sizes of all predicted points (_points_in_image_left) from the motion uncertainty
+  void _computeTrackingDistances();
+
+  //! @brief searches a track for a previous framepoint around its refined prediction if available, otherwise with the active window
+  //! @param[in] point_previous_ previous framepoint to track
+  //! @param[in] index_ index of the framepoint in the prediction buffers
+  //! @param[in] track_by_appearance_ left search criterion (appearance or projection distance)
+  //! @param[in,out] cache_ left descriptor distances of previous searches for this point
+  //! @param[out] match_ best left and right candidate (nullptr if not available)
+  void _searchTrack(const FramePoint* point_previous_,
+                    const Index& index_,
+                    const bool& track_by_appearance_,
+                    IntensityFeatureMatcher::RegionCache& cache_,
+                    TrackMatch& match_) const;
+
 //ds settings
 protected:
 
@@ -69,9 +203,51 @@ protected:
   //! @brief horizontal epipolar stereo matching search offsets (to consider for stereo matching)
   std::vector<int32_t> _epipolar_search_offsets_pixel;
 
+  //! @brief keypoint detection and descriptor extraction for the right image stream
+  IntensityFeatureExtractor _feature_extractor_right;
+
   //! @brief feature matching class (maintains features in a 2D lattice corresponding to the image and a vector)
   IntensityFeatureMatcher _feature_matcher_right;
 
+  //! @brief stereo match buffers (reused for each epipolar offset and frame)
+  StereoMatchVector _stereo_matches;
+  StereoCandidateVector _stereo_candidates;
+  std::vector<StereoMatchVector> _stereo_matches_per_band;
+  std::vector<int32_t> _band_row_begins;
+
+  //! @brief frame whose features are currently held by the matchers
+  Identifier _matcher_frame_identifier = 0;
+  bool _is_matcher_frame_valid         = false;
+
+  //! @brief right detection area: columns [0, _col_end_per_row_right[r]) of row r (only used with epipolar right detection)
+  std::vector<int32_t> _col_end_per_row_right;
+
+  //! @brief epipolar right detection: number of right detections and mode of the current one
+  Count _number_of_right_detections = 0;
+  bool _is_right_detection_partial  = false;
+
+  //! @brief row tables of the sorted left and right features (built once per frame, valid for all epipolar offsets)
+  std::vector<uint32_t> _row_begins_left;
+  std::vector<uint32_t> _row_begins_right;
+
+  //! @brief track buffers (reused for each frame): predicted left image projections (SoA) and candidates of all previous framepoints
+  Eigen::Matrix<real, 3, Eigen::Dynamic> _points_in_camera_left_previous;
+  Eigen::Matrix<real, 3, Eigen::Dynamic> _points_in_image_left;
+
+  //! @brief pyramid refined predictions (only valid where _is_prediction_refined is set, byte flags for concurrent writes)
+  Eigen::Matrix<real, 3, Eigen::Dynamic> _points_in_image_left_refined;
+  std::vector<uint8_t> _is_prediction_refined;
+
+  //! @brief adaptive search window half sizes (rows, cols) of all predicted points
+  Eigen::Matrix<int32_t, 2, Eigen::Dynamic> _tracking_distances_pixels;
+  TrackMatchVector _track_matches;
+
+  //! @brief left search regions and descriptor distances of all previous points, kept across tracking attempts for the same frames
+  std::vector<IntensityFeatureMatcher::RegionCache> _track_region_caches;
+  Identifier _track_region_caches_frame_identifier          = 0;
+  Identifier _track_region_caches_frame_identifier_previous = 0;
+  bool _are_track_region_caches_valid                       = false;
+
 private:
 
   //ds informative only
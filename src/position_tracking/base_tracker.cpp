@@ -1,5 +1,6 @@
 #include "base_tracker.h"
 #include "aligners/stereouv_aligner.h"
+#include <numeric>
 
 namespace proslam {
 using namespace srrg_core;
@@ -17,6 +18,27 @@ void BaseTracker::configure() {
   _lost_points.clear();
   _projection_tracking_distance_pixels = _framepoint_generator->parameters()->maximum_projection_tracking_distance_pixels;
 
+  //ds worker threads for parallel landmark updates and pose optimization if desired - the threads of the framepoint generator
+  //ds are reused if available (its stages never run concurrently to ours), otherwise we allocate our own
+  if ((_parameters->enable_parallel_landmark_updates || _parameters->aligner->enable_parallel_linearization) && !_worker_pool) {
+    _worker_pool = _framepoint_generator->workerPool();
+    if (!_worker_pool) {
+      _worker_pool          = new WorkerPool(_parameters->number_of_worker_threads);
+      _is_worker_pool_owned = true;
+    }
+    LOG_INFO(std::cerr << "BaseTracker::configure|parallel processing enabled (threads: "
+                       << _worker_pool->numberOfThreads() << ", shared: " << !_is_worker_pool_owned << ")" << std::endl)
+  }
+  if (_parameters->aligner->enable_parallel_linearization) {
+    _pose_optimizer->setWorkerPool(_worker_pool);
+  }
+
+  //ds allocate the pose hypothesis stage if desired
+  if (_parameters->enable_ransac_pose_hypothesis && !_pose_hypothesis_solver) {
+    _pose_hypothesis_solver = new RansacPoseSolver(_parameters);
+    _pose_hypothesis_solver->setMaximumReliableDepthMeters(_framepoint_generator->parameters()->maximum_reliable_depth_meters);
+  }
+
   //ds print tracker configuration (with dynamic type of parameters)
   LOG_INFO(std::cerr << "BaseTracker::configure|configured" << std::endl)
 }
@@ -29,6 +51,10 @@ BaseTracker::~BaseTracker() {
   //ds free dynamics
   delete _framepoint_generator;
   delete _pose_optimizer;
+  delete _pose_hypothesis_solver;
+  if (_is_worker_pool_owned) {
+    delete _worker_pool;
+  }
   LOG_INFO(std::cerr << "BaseTracker::~BaseTracker|destroyed" << std::endl)
 }
 
@@ -208,6 +234,7 @@ void BaseTracker::_track(Frame* previous_frame_,
   }
 
   //ds configure and track points in current frame
+  //ds with adaptive tracking windows the distance relative to its minimum scales the motion uncertainty of each point
   _framepoint_generator->setProjectionTrackingDistancePixels(_projection_tracking_distance_pixels);
   _framepoint_generator->track(current_frame_, previous_frame_, previous_to_current_, _lost_points, track_by_appearance_);
 
@@ -286,6 +313,19 @@ void BaseTracker::_registerRecursive(Frame* frame_previous_,
               << " (landmarks/framepoints: " << _number_of_tracked_landmarks << "/" << _number_of_tracked_points << ")" << std::endl)
   }
 
+  //ds replace the motion prior by a better pose hypothesis if available - its inliers define the robust optimization phase
+  //ds the hypothesis has to explain at least as many correspondences as the prior (the truncated error alone can favor fewer inliers)
+  if (_pose_hypothesis_solver) {
+    CHRONOMETER_START(pose_hypothesis)
+    if (_pose_hypothesis_solver->compute(frame_previous_, frame_current_, previous_to_current_) &&
+        _pose_hypothesis_solver->numberOfInliers() > _parameters->minimum_number_of_landmarks_to_track &&
+        _pose_hypothesis_solver->numberOfInliers() >= _pose_hypothesis_solver->numberOfInliersPrior()) {
+      previous_to_current_ = _pose_hypothesis_solver->previousToCurrent();
+      _pose_optimizer->setInlierHypothesis(_pose_hypothesis_solver->inliers());
+    }
+    CHRONOMETER_STOP(pose_hypothesis)
+  }
+
   //ds call pose solver
   CHRONOMETER_START(pose_optimization)
   _pose_optimizer->setEnableWeightsTranslation(true);
@@ -301,7 +341,10 @@ void BaseTracker::_registerRecursive(Frame* frame_previous_,
   if (number_of_inliers > _parameters->minimum_number_of_landmarks_to_track) {
 
     //ds info
-    if (recursion_ > 0) {
+    if (_pose_optimizer->hasExceededTimeBudget()) {
+      LOG_WARNING(std::cerr << frame_current_->identifier() << "|BaseTracker::_registerRecursive|alignment time budget exceeded (converged: "
+                            << _pose_optimizer->hasSystemConverged() << ")|inliers: " << number_of_inliers << " average error: " << average_error << std::endl)
+    } else if (recursion_ > 0) {
       LOG_INFO(std::cerr << frame_current_->identifier() << "|BaseTracker::_registerRecursive|recursion: " << recursion_
                          << "|inliers: " << number_of_inliers << " average error: " << average_error << std::endl)
     }
@@ -346,8 +389,8 @@ void BaseTracker::_registerRecursive(Frame* frame_previous_,
     LOG_WARNING(std::cerr << frame_current_->identifier() << "|BaseTracker::_registerRecursive|recursion: " << recursion_
                           << "|inliers: " << number_of_inliers << " average error: " << average_error << std::endl)
 
-    //ds if we have recursions left (currently only two)
-    if (recursion_ < 2) {
+    //ds if we have recursions left (currently only two) - a retry is skipped if the alignment already used up its time budget
+    if (recursion_ < 2 && !_pose_optimizer->hasExceededTimeBudget()) {
 
       //ds if we still can increase the tracking window size
       if (_projection_tracking_distance_pixels < _framepoint_generator->parameters()->maximum_projection_tracking_distance_pixels) {
@@ -417,10 +460,11 @@ void BaseTracker::_updatePoints(WorldMap* context_, Frame* frame_) {
   CHRONOMETER_START(landmark_optimization)
 
   //ds buffer current pose
-  const TransformMatrix3D& robot_to_world = frame_->robotToWorld();
+  const TransformMatrix3D& robot_to_world       = frame_->robotToWorld();
+  const TransformMatrix3D& world_to_camera_left = frame_->worldToCameraLeft();
 
-  //ds start landmark generation/update
-  _number_of_active_landmarks = 0;
+  //ds start landmark generation (serial, in point order)
+  _points_with_landmark.clear();
   for (FramePoint* point: frame_->points()) {
     point->setWorldCoordinates(robot_to_world*point->robotCoordinates());
 
@@ -429,24 +473,57 @@ void BaseTracker::_updatePoints(WorldMap* context_, Frame* frame_) {
       continue;
     }
 
-    //ds check if the point is linked to a landmark
-    Landmark* landmark = point->landmark();
-
-    //ds if there's no landmark yet
-    if (!landmark) {
-
-      //ds create a landmark and associate it with the current framepoint
-      landmark = context_->createLandmark(point);
+    //ds if there's no landmark yet - create a landmark and associate it with the current framepoint
+    if (!point->landmark()) {
+      context_->createLandmark(point);
+    }
+    _points_with_landmark.push_back(point);
+  }
+  _number_of_active_landmarks = _points_with_landmark.size();
+
+  //ds update landmark position based on current point (triggered as we linked the landmark to the point)
+  auto updateLandmark = [&world_to_camera_left](FramePoint* point_) {
+    Landmark* landmark = point_->landmark();
+    landmark->update(point_); // information filter 기반으로 최적화
+    point_->setCameraCoordinatesLeftLandmark(world_to_camera_left*landmark->coordinates());
+  };
+  if (_parameters->enable_parallel_landmark_updates && _number_of_active_landmarks > 1) {
+
+    //ds group the points by landmark - the updates of a landmark are processed in point order by a single job
+    _update_order.resize(_number_of_active_landmarks);
+    std::iota(_update_order.begin(), _update_order.end(), 0);
+    std::stable_sort(_update_order.begin(), _update_order.end(), [this](const Index& a_, const Index& b_) {
+      return _points_with_landmark[a_]->landmark()->identifier() < _points_with_landmark[b_]->landmark()->identifier();
+    });
+
+    //ds split into jobs of consecutive groups with at least the desired number of points
+    constexpr Count number_of_points_per_job = 64;
+    _update_job_begins.clear();
+    for (Index u = 0; u < _number_of_active_landmarks; ++u) {
+      const Landmark* landmark = _points_with_landmark[_update_order[u]]->landmark();
+      if (u == 0 || (u-_update_job_begins.back() >= number_of_points_per_job &&
+                     landmark != _points_with_landmark[_update_order[u-1]]->landmark())) {
+        _update_job_begins.push_back(u);
+      }
     }
+    _update_job_begins.push_back(_number_of_active_landmarks);
 
-    //ds update landmark position based on current point (triggered as we linked the landmark to the point)
-    landmark->update(point); // information filter 기반으로 최적화
-    point->setCameraCoordinatesLeftLandmark(frame_->worldToCameraLeft()*landmark->coordinates());
-    ++_number_of_active_landmarks;
+    //ds refine landmarks in parallel
+    _worker_pool->run(_update_job_begins.size()-1, [&](const Index& index_job_) {
+      for (Index u = _update_job_begins[index_job_]; u < _update_job_begins[index_job_+1]; ++u) {
+        updateLandmark(_points_with_landmark[_update_order[u]]);
+      }
+    });
+  } else {
+    for (FramePoint* point: _points_with_landmark) {
+      updateLandmark(point);
+    }
+  }
 
-    //ds VISUALIZATION ONLY: add landmarks to currently visible ones
-    landmark->setIsCurrentlyTracked(true);
-    context_->currentlyTrackedLandmarks().push_back(landmark);
+  //ds VISUALIZATION ONLY: add landmarks to currently visible ones
+  for (FramePoint* point: _points_with_landmark) {
+    point->landmark()->setIsCurrentlyTracked(true);
+    context_->currentlyTrackedLandmarks().push_back(point->landmark());
   }
   CHRONOMETER_STOP(landmark_optimization)
 }
@@ -1,7 +1,9 @@
 #pragma once
 #include "framepoint_generation/base_framepoint_generator.h"
 #include "aligners/base_frame_aligner.h"
+#include "aligners/ransac_pose_solver.h"
 #include "types/world_map.h"
+#include "types/worker_pool.h"
 
 namespace proslam {
 
@@ -100,6 +102,9 @@ protected:
   BaseFrameAligner* _pose_optimizer              = nullptr;
   BaseFramePointGenerator* _framepoint_generator = nullptr;
 
+  //! @brief pose hypothesis stage ahead of the pose optimization (only allocated if enabled)
+  RansacPoseSolver* _pose_hypothesis_solver = nullptr;
+
   //! @brief position tracking bookkeeping
   TransformMatrix3D _previous_to_current_camera = TransformMatrix3D::Identity();
 
@@ -108,6 +113,15 @@ protected:
   Count _number_of_recovered_points = 0;
   FramePointPointerVector _lost_points;
 
+  //! @brief landmark updates: points with landmarks (in point order), update order grouped by landmark and job boundaries
+  FramePointPointerVector _points_with_landmark;
+  std::vector<Index> _update_order;
+  std::vector<Index> _update_job_begins;
+
+  //! @brief worker threads for parallel landmark updates and pose optimization (shared with the framepoint generator if available)
+  WorkerPool* _worker_pool   = nullptr;
+  bool _is_worker_pool_owned = false;
+
   //ds stats only
   real _mean_number_of_keypoints   = 0;
   real _mean_number_of_framepoints = 0;
@@ -117,6 +131,7 @@ private:
   //ds informative only
   CREATE_CHRONOMETER(tracking)
   CREATE_CHRONOMETER(track_creation)
+  CREATE_CHRONOMETER(pose_hypothesis)
   CREATE_CHRONOMETER(pose_optimization)
   CREATE_CHRONOMETER(landmark_optimization)
   CREATE_CHRONOMETER(point_recovery)
@@ -48,37 +48,40 @@ namespace proslam {
 
     //ds obtain currently active tracking distance
     const real maximum_descriptor_distance = _framepoint_generator->parameters()->matching_distance_tracking_threshold;
+    const real minimum_disparity_pixels    = _stereo_framepoint_generator->parameters()->minimum_disparity_pixels;
+
+    //ds candidates are evaluated in parallel if desired (in jobs of consecutive points), the generator pool is shared
+    WorkerPool* worker_pool = (_stereo_framepoint_generator->parameters()->enable_parallel_tracking? _stereo_framepoint_generator->workerPool(): nullptr);
+    constexpr Count number_of_points_per_job = 64;
+    auto processPoints = [&](const Count& number_of_points_, const std::function<void(const Index&)>& process_) {
+      if (worker_pool && number_of_points_ > number_of_points_per_job) {
+        worker_pool->run((number_of_points_+number_of_points_per_job-1)/number_of_points_per_job, [&](const Index& index_job_) {
+          const Index index_end = std::min((index_job_+1)*number_of_points_per_job, number_of_points_);
+          for (Index u = index_job_*number_of_points_per_job; u < index_end; ++u) {
+            process_(u);
+          }
+        });
+      } else {
+        for (Index u = 0; u < number_of_points_; ++u) {
+          process_(u);
+        }
+      }
+    };
 
-    //ds buffers
-    const cv::Mat& intensity_image_left  = current_frame_->intensityImageLeft();
-    const cv::Mat& intensity_image_right = current_frame_->intensityImageRight();
-    std::vector<cv::KeyPoint> keypoint_buffer_left(1);
-    std::vector<cv::KeyPoint> keypoint_buffer_right(1);
-
-    //ds recover lost landmarks
-    Index index_lost_point_recovered = _number_of_tracked_points;
-    current_frame_->points().resize(_number_of_tracked_points+_number_of_lost_points);
-    for (FramePoint* point_previous: _lost_points) {
+    //ds project all lost landmarks into the current image pair - every lost point owns its slot
+    std::vector<cv::KeyPoint> keypoints_left(_number_of_lost_points);
+    std::vector<cv::KeyPoint> keypoints_right(_number_of_lost_points);
+    std::vector<uint8_t> is_candidate(_number_of_lost_points, 0);
+    processPoints(_number_of_lost_points, [&](const Index& index_) {
+      const FramePoint* point_previous = _lost_points[index_];
 
       //ds skip non landmarks for now (TODO parametrize)
       if (!point_previous->landmark()) {
-        continue;
+        return;
       }
 
-      //ds get point into current camera - based on last track
-      PointCoordinates point_in_camera_homogeneous(Vector3::Zero());
-
-      //ds if we have a landmark at hand
-      if (point_previous->landmark()) {
-        point_previous->landmark()->incrementNumberOfRecoveries();
-
-        //ds get point in camera frame based on landmark coordinates
-        point_in_camera_homogeneous = world_to_camera_left*point_previous->landmark()->coordinates();
-      } else {
-
-        //ds get point in camera frame based on point coordinates
-        point_in_camera_homogeneous = world_to_camera_left*point_previous->worldCoordinates();
-      }
+      //ds get point in camera frame based on landmark coordinates
+      const PointCoordinates point_in_camera_homogeneous = world_to_camera_left*point_previous->landmark()->coordinates();
 
       //ds obtain point projection on camera image plane
       PointCoordinates point_in_image_left  = camera_calibration_matrix*point_in_camera_homogeneous;
@@ -94,7 +97,7 @@ namespace proslam {
           point_in_image_left.y() < 0 || point_in_image_left.y() > _camera_left->numberOfImageRows()  ) {
 
         //ds out of FOV
-        continue;
+        return;
       }
       assert(point_in_image_left.y() == point_in_image_right.y());
 
@@ -104,8 +107,6 @@ namespace proslam {
 
       //ds this can be moved outside of the loop if keypoint sizes are constant
       const float regional_border_center = 5*point_previous->keypointLeft().size;
-      const cv::Point2f offset_keypoint_half(regional_border_center, regional_border_center);
-      const float regional_full_height = regional_border_center+regional_border_center+1;
 
       //ds if available search range is insufficient
       if (projection_left.x <= regional_border_center+1                                   ||
@@ -116,65 +117,95 @@ namespace proslam {
           projection_right.x >= _camera_left->numberOfImageCols()-regional_border_center-1) {
 
         //ds skip complete tracking
-        continue;
+        return;
       }
 
-      //ds left search regions
-      const cv::Point2f corner_left(projection_left-offset_keypoint_half);
-      const cv::Rect_<float> region_of_interest_left(corner_left.x, corner_left.y, regional_full_height, regional_full_height);
+      //ds descriptors are extracted at the projections
+      keypoints_left[index_]     = point_previous->keypointLeft();
+      keypoints_left[index_].pt  = projection_left;
+      keypoints_right[index_]    = point_previous->keypointRight();
+      keypoints_right[index_].pt = projection_right;
+      is_candidate[index_]       = 1;
+    });
+
+    //ds gather candidates in lost point order
+    std::vector<Index> indices_lost_point;
+    indices_lost_point.reserve(_number_of_lost_points);
+    for (Index u = 0; u < _number_of_lost_points; ++u) {
+      if (is_candidate[u]) {
+        keypoints_left[indices_lost_point.size()]  = keypoints_left[u];
+        keypoints_right[indices_lost_point.size()] = keypoints_right[u];
+        indices_lost_point.push_back(u);
+      }
+    }
+    const Count number_of_candidates = indices_lost_point.size();
+    keypoints_left.resize(number_of_candidates);
+    keypoints_right.resize(number_of_candidates);
+
+    //ds extract descriptors at all candidate positions with a single extraction per image (both images concurrently if possible)
+    DescriptorVector descriptors_left;
+    DescriptorVector descriptors_right;
+    std::vector<uint8_t> is_described_left;
+    std::vector<uint8_t> is_described_right;
+    if (worker_pool) {
+      worker_pool->run(2, [&](const Index& index_) {
+        if (index_ == 0) {
+          _stereo_framepoint_generator->describeKeypoints(current_frame_->intensityImageLeft(), keypoints_left, descriptors_left, is_described_left);
+        } else {
+          _stereo_framepoint_generator->describeKeypointsRight(current_frame_->intensityImageRight(), keypoints_right, descriptors_right, is_described_right);
+        }
+      });
+    } else {
+      _stereo_framepoint_generator->describeKeypoints(current_frame_->intensityImageLeft(), keypoints_left, descriptors_left, is_described_left);
+      _stereo_framepoint_generator->describeKeypointsRight(current_frame_->intensityImageRight(), keypoints_right, descriptors_right, is_described_right);
+    }
 
-      //ds extract descriptors at this position: LEFT
-      keypoint_buffer_left[0]    = point_previous->keypointLeft();
-      keypoint_buffer_left[0].pt = offset_keypoint_half;
-      cv::Mat descriptor_left;
-      const cv::Mat roi_left(intensity_image_left(region_of_interest_left));
-      _framepoint_generator->descriptorExtractor()->compute(roi_left, keypoint_buffer_left, descriptor_left);
+    //ds validate candidates against the appearance of the lost points and triangulate them
+    std::vector<uint8_t> is_recovered(number_of_candidates, 0);
+    PointCoordinatesVector points_in_camera_left(number_of_candidates);
+    processPoints(number_of_candidates, [&](const Index& index_) {
+      const FramePoint* point_previous = _lost_points[indices_lost_point[index_]];
 
-      //ds if no descriptor could be computed
-      if (descriptor_left.rows == 0) {
-        continue;
+      //ds if no descriptor could be computed or if descriptor distance is to high
+      if (!is_described_left[index_] ||
+          HammingDistance::compute(point_previous->descriptorLeft(), descriptors_left[index_]) > maximum_descriptor_distance) {
+        return;
       }
-
-      //ds if descriptor distance is to high
-      if (cv::norm(point_previous->descriptorLeft(), descriptor_left, SRRG_PROSLAM_DESCRIPTOR_NORM) > maximum_descriptor_distance) {
-        continue;
+      if (!is_described_right[index_] ||
+          HammingDistance::compute(point_previous->descriptorRight(), descriptors_right[index_]) > maximum_descriptor_distance) {
+        return;
       }
-      keypoint_buffer_left[0].pt += corner_left;
-
-      //ds right search region
-      const cv::Point2f corner_right(projection_right-offset_keypoint_half);
-      const cv::Rect_<float> region_of_interest_right(corner_right.x, corner_right.y, regional_full_height, regional_full_height);
 
-      //ds extract descriptors at this position: RIGHT
-      keypoint_buffer_right[0] = point_previous->keypointRight();
-      keypoint_buffer_right[0].pt = offset_keypoint_half;
-      cv::Mat descriptor_right;
-      const cv::Mat roi_right(intensity_image_right(region_of_interest_right));
-      _framepoint_generator->descriptorExtractor()->compute(roi_right, keypoint_buffer_right, descriptor_right);
-
-      //ds if no descriptor could be computed
-      if (descriptor_right.rows == 0) {
-        continue;
+      //ds skip points with insufficient stereo disparity
+      if (keypoints_left[index_].pt.x-keypoints_right[index_].pt.x < minimum_disparity_pixels) {
+        return;
       }
+      points_in_camera_left[index_] = _stereo_framepoint_generator->getPointInLeftCamera(keypoints_left[index_].pt, keypoints_right[index_].pt);
+      is_recovered[index_]          = 1;
+    });
 
-      //ds if descriptor distance is to high
-      if (cv::norm(point_previous->descriptorRight(), descriptor_right, SRRG_PROSLAM_DESCRIPTOR_NORM) > maximum_descriptor_distance) {
-        continue;
+    //ds count recovery attempts for all lost landmarks
+    for (FramePoint* point_previous: _lost_points) {
+      if (point_previous->landmark()) {
+        point_previous->landmark()->incrementNumberOfRecoveries();
       }
-      keypoint_buffer_right[0].pt += corner_right;
+    }
 
-      //ds skip points with insufficient stereo disparity
-      if (keypoint_buffer_left[0].pt.x-keypoint_buffer_right[0].pt.x < _stereo_framepoint_generator->parameters()->minimum_disparity_pixels) {
+    //ds allocate recovered points in lost point order
+    Index index_lost_point_recovered = _number_of_tracked_points;
+    current_frame_->points().resize(_number_of_tracked_points+number_of_candidates);
+    for (Index u = 0; u < number_of_candidates; ++u) {
+      if (!is_recovered[u]) {
         continue;
       }
 
       //ds allocate a new point connected to the previous one
-      FramePoint* current_point = current_frame_->createFramepoint(keypoint_buffer_left[0],
-                                                                   descriptor_left,
-                                                                   keypoint_buffer_right[0],
-                                                                   descriptor_right,
-                                                                   _stereo_framepoint_generator->getPointInLeftCamera(keypoint_buffer_left[0].pt, keypoint_buffer_right[0].pt),
-                                                                   point_previous);
+      FramePoint* current_point = current_frame_->createFramepoint(keypoints_left[u],
+                                                                   descriptors_left[u],
+                                                                   keypoints_right[u],
+                                                                   descriptors_right[u],
+                                                                   points_in_camera_left[u],
+                                                                   _lost_points[indices_lost_point[u]]);
 
       //ds set the point to the control structure
       current_frame_->points()[index_lost_point_recovered] = current_point;
@@ -721,6 +721,7 @@ void SLAMAssembly::printReport() const {
   }
 
   std::printf("               tracking | %f | %f\n", _tracker->getTimeConsumptionSeconds_tracking()/_processing_time_total_seconds, _tracker->getTimeConsumptionSeconds_tracking());
+  std::printf("        pose hypothesis | %f | %f\n", _tracker->getTimeConsumptionSeconds_pose_hypothesis()/_processing_time_total_seconds, _tracker->getTimeConsumptionSeconds_pose_hypothesis());
   std::printf("      pose optimization | %f | %f\n", _tracker->getTimeConsumptionSeconds_pose_optimization()/_processing_time_total_seconds, _tracker->getTimeConsumptionSeconds_pose_optimization());
   std::printf("  landmark optimization | %f | %f\n", _tracker->getTimeConsumptionSeconds_landmark_optimization()/_processing_time_total_seconds, _tracker->getTimeConsumptionSeconds_landmark_optimization());
   std::printf("         point recovery | %f | %f\n", _tracker->getTimeConsumptionSeconds_point_recovery()/_processing_time_total_seconds, _tracker->getTimeConsumptionSeconds_point_recovery());
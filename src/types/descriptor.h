@@ -0,0 +1,43 @@
+#pragma once
+#include "definitions.h"
+#include <cstring>
+
+namespace proslam {
+
+//! @struct fixed size binary descriptor of SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS bits, stored inline (no heap allocation, no reference counting)
+//! the bytes are laid out exactly as in a row of an OpenCV descriptor matrix (CV_8U), unused trailing bytes are zero
+struct Descriptor {
+
+  //! @brief number of 64 bit words required to store a descriptor
+  static constexpr uint32_t number_of_words = (SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS+63)/64;
+
+  //! @brief copies a descriptor from a raw buffer
+  //! @param[in] bytes_ buffer of DESCRIPTOR_SIZE_BYTES bytes
+  //! @return descriptor copy
+  static inline Descriptor fromBytes(const uint8_t* bytes_) {
+    Descriptor descriptor = {};
+    std::memcpy(descriptor.words, bytes_, DESCRIPTOR_SIZE_BYTES);
+    return descriptor;
+  }
+
+  //! @brief copies a descriptor from a descriptor matrix row
+  //! @param[in] descriptors_ descriptor matrix (CV_8U, DESCRIPTOR_SIZE_BYTES columns)
+  //! @param[in] row_ row to copy
+  //! @return descriptor copy
+  static inline Descriptor fromMat(const cv::Mat& descriptors_, const int32_t& row_ = 0) {
+    assert(descriptors_.cols == DESCRIPTOR_SIZE_BYTES && row_ < descriptors_.rows);
+    return fromBytes(descriptors_.ptr<uint8_t>(row_));
+  }
+
+  //! @brief wraps the descriptor in a single row matrix header without copying (the header must not outlive the descriptor)
+  inline cv::Mat toMat() const {return cv::Mat(1, DESCRIPTOR_SIZE_BYTES, CV_8U, const_cast<uint64_t*>(words));}
+
+  inline const uint8_t* data() const {return reinterpret_cast<const uint8_t*>(words);}
+  inline uint8_t* data() {return reinterpret_cast<uint8_t*>(words);}
+
+  //! @brief descriptor bits
+  uint64_t words[number_of_words];
+};
+
+typedef std::vector<Descriptor> DescriptorVector;
+} //namespace proslam
@@ -55,9 +55,9 @@ void Frame::setRobotToWorld(const TransformMatrix3D& robot_to_world_, const bool
 }
 
 FramePoint* Frame::createFramepoint(const cv::KeyPoint& keypoint_left_,
-                                    const cv::Mat& descriptor_left_,
+                                    const Descriptor& descriptor_left_,
                                     const cv::KeyPoint& keypoint_right_,
-                                    const cv::Mat& descriptor_right_,
+                                    const Descriptor& descriptor_right_,
                                     const PointCoordinates& camera_coordinates_left_,
                                     FramePoint* previous_point_) {
   assert(_camera_left != 0);
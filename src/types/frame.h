@@ -88,9 +88,9 @@ public:
 
   //ds request a new framepoint instance with an optional link to a previous point (track)
   FramePoint* createFramepoint(const cv::KeyPoint& keypoint_left_,
-                     const cv::Mat& descriptor_left_,
+                     const Descriptor& descriptor_left_,
                      const cv::KeyPoint& keypoint_right_,
-                     const cv::Mat& descriptor_right_,
+                     const Descriptor& descriptor_right_,
                      const PointCoordinates& camera_coordinates_left_,
                      FramePoint* previous_point_ = 0);
 
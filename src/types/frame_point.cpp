@@ -6,9 +6,9 @@ namespace proslam {
 Count FramePoint::_instances = 0;
 
 FramePoint::FramePoint(const cv::KeyPoint& keypoint_left_,
-                       const cv::Mat& descriptor_left_,
+                       const Descriptor& descriptor_left_,
                        const cv::KeyPoint& keypoint_right_,
-                       const cv::Mat& descriptor_right_,
+                       const Descriptor& descriptor_right_,
                        Frame* frame_): row(keypoint_left_.pt.y),
                                        col(keypoint_left_.pt.x),
                                        _identifier(_instances),
@@ -25,15 +25,7 @@ FramePoint::FramePoint(const cv::KeyPoint& keypoint_left_,
 
 FramePoint::FramePoint(const IntensityFeature* feature_left_,
                        const IntensityFeature* feature_right_,
-                       Frame* frame_): FramePoint(feature_left_->keypoint, feature_left_->descriptor, feature_right_->keypoint,  feature_right_->descriptor, frame_) {
-  _feature_left  = feature_left_;
-  _feature_right = feature_right_;
-}
-
-FramePoint::~FramePoint() {
-  delete _feature_left;
-  delete _feature_right;
-}
+                       Frame* frame_): FramePoint(feature_left_->keypoint, feature_left_->descriptor, feature_right_->keypoint,  feature_right_->descriptor, frame_) {}
 
 void FramePoint::setPrevious(FramePoint* previous_) {
 
@@ -1,5 +1,5 @@
 #pragma once
-#include "definitions.h"
+#include "hamming_distance.h"
 #include "srrg_hbst/types/binary_tree.hpp"
 
 namespace proslam {
@@ -20,14 +20,22 @@ struct IntensityFeature {
   IntensityFeature(): row(0), col(0), index_in_vector(0) {}
 
   IntensityFeature(const cv::KeyPoint& keypoint_,
-                   const cv::Mat& descriptor_,
+                   const Descriptor& descriptor_,
                    const size_t& index_in_vector_): keypoint(keypoint_),
                                                     descriptor(descriptor_),
                                                     row(keypoint_.pt.y),
                                                     col(keypoint_.pt.x),
                                                     index_in_vector(index_in_vector_) {}
+
+  //ds without descriptor (computed on demand by the matcher owning the feature)
+  IntensityFeature(const cv::KeyPoint& keypoint_,
+                   const size_t& index_in_vector_): keypoint(keypoint_),
+                                                    descriptor(),
+                                                    row(keypoint_.pt.y),
+                                                    col(keypoint_.pt.x),
+                                                    index_in_vector(index_in_vector_) {}
   cv::KeyPoint keypoint;  //ds geometric: feature location in 2D
-  cv::Mat descriptor;     //ds appearance: feature descriptor
+  Descriptor descriptor;  //ds appearance: feature descriptor
   int32_t row;            //ds pixel column coordinate (v)
   int32_t col;            //ds pixel row coordinate (u)
   size_t index_in_vector; //ds inverted index for vector containing this
@@ -47,17 +55,17 @@ protected:
 
   //ds construct a new framepoint, owned by the provided Frame
   FramePoint(const cv::KeyPoint& keypoint_left_,
-             const cv::Mat& descriptor_left_,
+             const Descriptor& descriptor_left_,
              const cv::KeyPoint& keypoint_right_,
-             const cv::Mat& descriptor_right_,
+             const Descriptor& descriptor_right_,
              Frame* frame_);
 
-  //ds construct a new framepoint, owned by the provided Frame
+  //ds construct a new framepoint, owned by the provided Frame (the features are copied, they are not owned by the framepoint)
   FramePoint(const IntensityFeature* feature_left_,
              const IntensityFeature* feature_right_,
              Frame* frame_);
 
-  ~FramePoint();
+  ~FramePoint() {}
 
 //ds getters/setters
 public:
@@ -115,8 +123,8 @@ public:
   //ds measured properties
   inline const cv::KeyPoint& keypointLeft() const {return _keypoint_left;}
   inline const cv::KeyPoint& keypointRight() const {return _keypoint_right;}
-  inline const cv::Mat& descriptorLeft() const {return _descriptor_left;}
-  inline const cv::Mat& descriptorRight() const {return _descriptor_right;}
+  inline const Descriptor& descriptorLeft() const {return _descriptor_left;}
+  inline const Descriptor& descriptorRight() const {return _descriptor_right;}
   inline const real& disparityPixels() const {return _disparity_pixels;}
 
   //ds reset allocated object counter
@@ -154,18 +162,14 @@ protected:
   //ds triangulation information (set by StereoFramePointGenerator)
   const cv::KeyPoint _keypoint_left;
   const cv::KeyPoint _keypoint_right;
-  const cv::Mat _descriptor_left;
-  const cv::Mat _descriptor_right;
+  const Descriptor _descriptor_left;
+  const Descriptor _descriptor_right;
   const real _disparity_pixels;
   real _descriptor_distance_triangulation;
 
   //! @brief epipolar offset at triangulation (0 for regular, horizontal triangulation)
   int32_t _epipolar_offset = 0;
 
-  //! @brief feature objects
-  const IntensityFeature* _feature_left  = nullptr;
-  const IntensityFeature* _feature_right = nullptr;
-
   //ds spatial properties
   PointCoordinates _image_coordinates_left;
   PointCoordinates _image_coordinates_right;
@@ -200,5 +204,4 @@ private:
 };
 
 typedef std::vector<FramePoint*> FramePointPointerVector;
-typedef FramePoint*** FramePointMatrix;
 }
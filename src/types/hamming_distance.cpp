@@ -0,0 +1,153 @@
+#include "hamming_distance.h"
+#include <cstring>
+
+#if defined(__x86_64__)
+  #include <immintrin.h>
+  #define SRRG_PROSLAM_HAMMING_HAS_X86_KERNELS
+#endif
+
+namespace proslam {
+
+//ds number of complete 64 bit words per descriptor and remaining bytes
+static constexpr uint32_t number_of_words           = DESCRIPTOR_SIZE_BYTES/8;
+static constexpr uint32_t number_of_remaining_bytes = DESCRIPTOR_SIZE_BYTES%8;
+
+//ds portable bit counting (no special instructions)
+static inline uint32_t countBits(uint64_t value_) {
+  value_ = value_-((value_ >> 1) & 0x5555555555555555ULL);
+  value_ = (value_ & 0x3333333333333333ULL)+((value_ >> 2) & 0x3333333333333333ULL);
+  value_ = (value_+(value_ >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (value_*0x0101010101010101ULL) >> 56;
+}
+
+//ds distance of the bytes that do not fill a complete word
+static inline uint32_t computeRemainingBytes(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  uint64_t word_a = 0;
+  uint64_t word_b = 0;
+  std::memcpy(&word_a, descriptor_a_+8*number_of_words, number_of_remaining_bytes);
+  std::memcpy(&word_b, descriptor_b_+8*number_of_words, number_of_remaining_bytes);
+  return countBits(word_a ^ word_b);
+}
+
+static uint32_t computeScalar(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  uint32_t distance = 0;
+  for (uint32_t u = 0; u < number_of_words; ++u) {
+    uint64_t word_a, word_b;
+    std::memcpy(&word_a, descriptor_a_+8*u, 8);
+    std::memcpy(&word_b, descriptor_b_+8*u, 8);
+    distance += countBits(word_a ^ word_b);
+  }
+  if (number_of_remaining_bytes > 0) {
+    distance += computeRemainingBytes(descriptor_a_, descriptor_b_);
+  }
+  return distance;
+}
+
+#ifdef SRRG_PROSLAM_HAMMING_HAS_X86_KERNELS
+__attribute__((target("popcnt")))
+static uint32_t computePOPCNT(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  uint64_t distance = 0;
+  for (uint32_t u = 0; u < number_of_words; ++u) {
+    uint64_t word_a, word_b;
+    std::memcpy(&word_a, descriptor_a_+8*u, 8);
+    std::memcpy(&word_b, descriptor_b_+8*u, 8);
+    distance += _mm_popcnt_u64(word_a ^ word_b);
+  }
+  if (number_of_remaining_bytes > 0) {
+    distance += computeRemainingBytes(descriptor_a_, descriptor_b_);
+  }
+  return distance;
+}
+
+__attribute__((target("avx2,popcnt")))
+static uint32_t computeAVX2(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  constexpr uint32_t number_of_blocks = DESCRIPTOR_SIZE_BYTES/32;
+
+  //ds count bits per nibble with a lookup table and accumulate per 64 bit lane
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                          0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i mask_low_nibble = _mm256_set1_epi8(0x0F);
+  __m256i sums = _mm256_setzero_si256();
+  for (uint32_t u = 0; u < number_of_blocks; ++u) {
+    const __m256i block = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(descriptor_a_+32*u)),
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(descriptor_b_+32*u)));
+    const __m256i count_low  = _mm256_shuffle_epi8(lookup, _mm256_and_si256(block, mask_low_nibble));
+    const __m256i count_high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(block, 4), mask_low_nibble));
+    sums = _mm256_add_epi64(sums, _mm256_sad_epu8(_mm256_add_epi8(count_low, count_high), _mm256_setzero_si256()));
+  }
+  uint64_t distance = _mm256_extract_epi64(sums, 0)+_mm256_extract_epi64(sums, 1)+
+                      _mm256_extract_epi64(sums, 2)+_mm256_extract_epi64(sums, 3);
+
+  //ds remaining words that do not fill a complete register
+  for (uint32_t u = 4*number_of_blocks; u < number_of_words; ++u) {
+    uint64_t word_a, word_b;
+    std::memcpy(&word_a, descriptor_a_+8*u, 8);
+    std::memcpy(&word_b, descriptor_b_+8*u, 8);
+    distance += _mm_popcnt_u64(word_a ^ word_b);
+  }
+  if (number_of_remaining_bytes > 0) {
+    distance += computeRemainingBytes(descriptor_a_, descriptor_b_);
+  }
+  return distance;
+}
+
+__attribute__((target("avx512f,avx512vl,avx512vpopcntdq,popcnt")))
+static uint32_t computeAVX512VPOPCNTDQ(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+  constexpr uint32_t number_of_blocks_512 = DESCRIPTOR_SIZE_BYTES/64;
+  constexpr uint32_t number_of_blocks_256 = (DESCRIPTOR_SIZE_BYTES%64)/32;
+  uint64_t distance = 0;
+
+  //ds full 512 bit blocks
+  if (number_of_blocks_512 > 0) {
+    __m512i sums = _mm512_setzero_si512();
+    for (uint32_t u = 0; u < number_of_blocks_512; ++u) {
+      const __m512i block = _mm512_xor_si512(_mm512_loadu_si512(descriptor_a_+64*u), _mm512_loadu_si512(descriptor_b_+64*u));
+      sums = _mm512_add_epi64(sums, _mm512_popcnt_epi64(block));
+    }
+    distance += _mm512_reduce_add_epi64(sums);
+  }
+
+  //ds a remaining 256 bit block (e.g. the complete 256 bit descriptor)
+  if (number_of_blocks_256 > 0) {
+    const uint8_t* block_a = descriptor_a_+64*number_of_blocks_512;
+    const uint8_t* block_b = descriptor_b_+64*number_of_blocks_512;
+    const __m256i counts = _mm256_popcnt_epi64(_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(block_a)),
+                                                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block_b))));
+    const __m128i sums = _mm_add_epi64(_mm256_castsi256_si128(counts), _mm256_extracti128_si256(counts, 1));
+    distance += _mm_cvtsi128_si64(sums)+_mm_extract_epi64(sums, 1);
+  }
+
+  //ds remaining words that do not fill a complete register
+  for (uint32_t u = 8*number_of_blocks_512+4*number_of_blocks_256; u < number_of_words; ++u) {
+    uint64_t word_a, word_b;
+    std::memcpy(&word_a, descriptor_a_+8*u, 8);
+    std::memcpy(&word_b, descriptor_b_+8*u, 8);
+    distance += _mm_popcnt_u64(word_a ^ word_b);
+  }
+  if (number_of_remaining_bytes > 0) {
+    distance += computeRemainingBytes(descriptor_a_, descriptor_b_);
+  }
+  return distance;
+}
+#endif
+
+HammingDistance::Kernel HammingDistance::_kernel = &computeScalar;
+std::string HammingDistance::_kernel_name        = "scalar";
+const bool HammingDistance::_is_kernel_selected  = (HammingDistance::_selectKernel(), true);
+
+void HammingDistance::_selectKernel() {
+#ifdef SRRG_PROSLAM_HAMMING_HAS_X86_KERNELS
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512vpopcntdq") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("popcnt")) {
+    _kernel      = &computeAVX512VPOPCNTDQ;
+    _kernel_name = "AVX-512 VPOPCNTDQ";
+  } else if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+    _kernel      = &computeAVX2;
+    _kernel_name = "AVX2";
+  } else if (__builtin_cpu_supports("popcnt")) {
+    _kernel      = &computePOPCNT;
+    _kernel_name = "POPCNT";
+  }
+#endif
+}
+} //namespace proslam
@@ -0,0 +1,59 @@
+#pragma once
+#include "descriptor.h"
+
+namespace proslam {
+
+//! @class fixed width Hamming distance computation for binary descriptors of DESCRIPTOR_SIZE_BYTES bytes
+//! the fastest kernel supported by the executing CPU is selected once at startup:
+//! scalar (portable), POPCNT, AVX2 (nibble lookup) or AVX-512 VPOPCNTDQ
+class HammingDistance {
+
+//ds functionality
+public:
+
+  //! @brief computes the Hamming distance between two descriptors
+  //! @param[in] descriptor_a_ first descriptor (DESCRIPTOR_SIZE_BYTES bytes)
+  //! @param[in] descriptor_b_ second descriptor (DESCRIPTOR_SIZE_BYTES bytes)
+  //! @return number of differing bits
+  static inline uint32_t compute(const uint8_t* descriptor_a_, const uint8_t* descriptor_b_) {
+    return _kernel(descriptor_a_, descriptor_b_);
+  }
+
+  //! @brief computes the Hamming distance between two inline descriptors
+  //! @param[in] descriptor_a_ first descriptor
+  //! @param[in] descriptor_b_ second descriptor
+  //! @return number of differing bits
+  static inline uint32_t compute(const Descriptor& descriptor_a_, const Descriptor& descriptor_b_) {
+    return _kernel(descriptor_a_.data(), descriptor_b_.data());
+  }
+
+  //! @brief computes the Hamming distance between two descriptor matrix rows
+  //! @param[in] descriptor_a_ first descriptor (single row, CV_8U)
+  //! @param[in] descriptor_b_ second descriptor (single row, CV_8U)
+  //! @return number of differing bits
+  static inline uint32_t compute(const cv::Mat& descriptor_a_, const cv::Mat& descriptor_b_) {
+    assert(descriptor_a_.cols == DESCRIPTOR_SIZE_BYTES && descriptor_b_.cols == DESCRIPTOR_SIZE_BYTES);
+    return _kernel(descriptor_a_.ptr<uint8_t>(0), descriptor_b_.ptr<uint8_t>(0));
+  }
+
+  //! @brief name of the selected kernel (informative only)
+  static const std::string& kernelName() {return _kernel_name;}
+
+//ds helpers
+protected:
+
+  //! @brief selects the fastest kernel available on the executing CPU
+  static void _selectKernel();
+
+//ds attributes
+protected:
+
+  //! @brief active kernel (scalar until the selection at startup)
+  typedef uint32_t (*Kernel)(const uint8_t*, const uint8_t*);
+  static Kernel _kernel;
+  static std::string _kernel_name;
+
+  //! @brief triggers the kernel selection during static initialization
+  static const bool _is_kernel_selected;
+};
+} //namespace proslam
@@ -5,6 +5,20 @@ namespace proslam {
 
 Count Landmark::_instances = 0;
 
+//ds bounded history: keeps every second element (starting with the first) and doubles the sampling stride if the history is too long
+template<typename ElementVector>
+static bool thinOut(ElementVector& history_, Count& stride_, const Count& maximum_length_) {
+  if (maximum_length_ == 0 || history_.size() <= maximum_length_) {
+    return false;
+  }
+  for (Index u = 1; 2*u < history_.size(); ++u) {
+    history_[u] = history_[2*u];
+  }
+  history_.resize((history_.size()+1)/2);
+  stride_ *= 2;
+  return true;
+}
+
 Landmark::Landmark(FramePoint* origin_, const LandmarkParameters* parameters_): _identifier(_instances),
                                                                                 _origin(origin_),
                                                                                 _parameters(parameters_) {
@@ -18,16 +32,25 @@ Landmark::Landmark(FramePoint* origin_, const LandmarkParameters* parameters_):
   //ds we do not weight the measurements with disparity/inverse depth here
   //ds since invalid, small depths can lead to a fatal initial guess
   _world_coordinates.setZero();
+  MeasurementVector measurements;
   FramePoint* framepoint = origin_;
   while (framepoint) {
     framepoint->setLandmark(this);
-    _measurements.push_back(Measurement(framepoint));
+    measurements.push_back(Measurement(framepoint));
     _origin = framepoint;
     _world_coordinates += framepoint->worldCoordinates();
     framepoint = framepoint->previous();
   }
-  _world_coordinates /= _measurements.size();
-  _number_of_updates = _measurements.size();
+  _world_coordinates_accumulated = _world_coordinates;
+  _world_coordinates /= measurements.size();
+  _number_of_updates            = measurements.size();
+  _number_of_inliers_in_history = measurements.size();
+
+  //ds accumulate the track information at the initial guess and store the track - all track measurements count as updates
+  for (const Measurement& measurement: measurements) {
+    _addToInformation(measurement);
+    _addToHistory(measurement);
+  }
 }
 
 Landmark::~Landmark() {
@@ -51,9 +74,23 @@ void Landmark::replace(const HBSTMatchable* matchable_old_, HBSTMatchable* match
 void Landmark::update(FramePoint* point_) {
   _last_update = point_;
 
-  //ds update appearance history (left descriptors only)
-  _descriptors.push_back(point_->descriptorLeft());
-  _measurements.push_back(Measurement(point_));
+  //ds update appearance history (left descriptors only, bounded)
+  if (_number_of_descriptors % _descriptor_stride == 0) {
+    _descriptors.push_back(point_->descriptorLeft());
+  }
+  ++_number_of_descriptors;
+  thinOut(_descriptors, _descriptor_stride, _parameters->maximum_history_length);
+
+  //ds update measurement history
+  const Measurement measurement(point_);
+  _world_coordinates_accumulated += point_->worldCoordinates();
+  _addToHistory(measurement);
+
+  //ds constant time update from the accumulated information if desired
+  if (_parameters->enable_incremental_update) {
+    _updateIncremental(measurement);
+    return;
+  }
 
   //ds trigger classic ICP in camera update of landmark coordinates - setup
   Vector3 world_coordinates(_world_coordinates);
@@ -63,7 +100,6 @@ void Landmark::update(FramePoint* point_) {
   Matrix3 jacobian_transposed;
   Matrix3 omega(Matrix3::Identity());
   real total_error_squared_previous = 0;
-  const real maximum_error_squared_meters = 5*5;
 
   //ds gauss newton descent
   for (uint32_t iteration = 0; iteration < 1000; ++iteration) {
@@ -77,7 +113,7 @@ void Landmark::update(FramePoint* point_) {
       omega.setIdentity();
 
       //ds sample current state in measurement context
-      const PointCoordinates camera_coordinates_sampled = measurement.world_to_camera*world_coordinates;
+      const PointCoordinates camera_coordinates_sampled = measurement.toCamera(world_coordinates);
       if (camera_coordinates_sampled.z() <= 0) {
         ++number_of_outliers;
         continue;
@@ -94,13 +130,13 @@ void Landmark::update(FramePoint* point_) {
       total_error_squared += error_squared;
 
       //ds robust kernel
-      if (error_squared > maximum_error_squared_meters) {
-        omega *= maximum_error_squared_meters/error_squared;
+      if (error_squared > _maximum_error_squared_meters) {
+        omega *= _maximum_error_squared_meters/error_squared;
         ++number_of_outliers;
       }
 
       //ds get the jacobian of the transform part: R
-      jacobian = measurement.world_to_camera.linear();
+      jacobian = measurement.world_to_camera_rotation.cast<real>();
 
       //ds precompute transposed
       jacobian_transposed = jacobian.transpose();
@@ -118,23 +154,18 @@ void Landmark::update(FramePoint* point_) {
       const uint32_t number_of_inliers = _measurements.size()-number_of_outliers;
 
       //ds if the number of inliers is higher than the best so far
-      if (number_of_inliers > _number_of_updates) {
+      if (number_of_inliers > _number_of_inliers_in_history) {
 
         //ds update landmark state
         _world_coordinates = world_coordinates;
-        _number_of_updates        = number_of_inliers;
+        _number_of_updates += number_of_inliers-_number_of_inliers_in_history;
+        _number_of_inliers_in_history = number_of_inliers;
 
       //ds if optimization failed and we have less inliers than outliers - reset initial guess
       } else if (number_of_inliers < number_of_outliers) {
 
-        //ds reset estimate based on overall average
-        PointCoordinates world_coordinates_accumulated(PointCoordinates::Zero());
-        for (const Measurement& measurement: _measurements) {
-          world_coordinates_accumulated += measurement.world_coordinates;
-        }
-
-        //ds set landmark state without increasing update count
-        _world_coordinates = world_coordinates_accumulated/_measurements.size();
+        //ds set landmark state to the overall average without increasing update count
+        _world_coordinates = _world_coordinates_accumulated/_number_of_measurements;
       }
       break;
     }
@@ -144,6 +175,91 @@ void Landmark::update(FramePoint* point_) {
   }
 }
 
+bool Landmark::_addToInformation(const Measurement& measurement_) {
+
+  //ds sample current state in measurement context - measurements behind the camera are not integrated
+  const PointCoordinates camera_coordinates_sampled = measurement_.toCamera(_world_coordinates);
+  if (camera_coordinates_sampled.z() <= 0) {
+    return false;
+  }
+
+  //ds compute error and weight inverse depth
+  const Vector3 error(camera_coordinates_sampled-measurement_.camera_coordinates);
+  real omega = measurement_.inverse_depth_meters;
+  const real error_squared = omega*error.squaredNorm();
+
+  //ds robust kernel - the weight is fixed at the time of integration
+  bool is_inlier = true;
+  if (error_squared > _maximum_error_squared_meters) {
+    omega *= _maximum_error_squared_meters/error_squared;
+    is_inlier = false;
+  }
+
+  //ds the jacobian is the rotational part of the measurement transform, the solution of H*x = b minimizes all errors
+  const Matrix3 rotation(measurement_.world_to_camera_rotation.cast<real>());
+  _information_matrix += omega*rotation.transpose()*rotation;
+  _information_vector += omega*rotation.transpose()*(measurement_.camera_coordinates-measurement_.world_to_camera_translation);
+  return is_inlier;
+}
+
+void Landmark::_addToHistory(const Measurement& measurement_) {
+  if (_number_of_measurements % _measurement_stride == 0) {
+    _measurements.push_back(measurement_);
+  }
+  ++_number_of_measurements;
+
+  //ds the inliers of the last accepted solution are thinned out with the history
+  if (thinOut(_measurements, _measurement_stride, _parameters->maximum_history_length)) {
+    _number_of_inliers_in_history /= 2;
+  }
+}
+
+void Landmark::_updateIncremental(const Measurement& measurement_) {
+  if (_addToInformation(measurement_)) {
+    ++_number_of_updates;
+  } else {
+    ++_number_of_outliers;
+  }
+
+  //ds if we have less inliers than outliers - reset estimate based on overall average (the accumulated information is kept intact)
+  if (_number_of_updates < _number_of_outliers) {
+    _world_coordinates = _world_coordinates_accumulated/_number_of_measurements;
+
+  //ds periodically re-weight the stored measurements, the weights of the accumulated information are fixed at integration
+  } else if (_parameters->incremental_resolve_interval > 0 && _number_of_measurements % _parameters->incremental_resolve_interval == 0) {
+    _resolveIncremental();
+
+  //ds otherwise solve for the coordinates minimizing the error of all integrated measurements
+  } else if (_information_matrix.trace() > 0) {
+    _world_coordinates = _information_matrix.ldlt().solve(_information_vector);
+  }
+}
+
+void Landmark::_resolveIncremental() {
+  for (uint32_t iteration = 0; iteration < 10; ++iteration) {
+
+    //ds accumulate the history with weights at the current estimate - a stored measurement represents stride measurements
+    _information_matrix.setZero();
+    _information_vector.setZero();
+    for (const Measurement& measurement: _measurements) {
+      _addToInformation(measurement);
+    }
+    _information_matrix *= _measurement_stride;
+    _information_vector *= _measurement_stride;
+    if (_information_matrix.trace() <= 0) {
+      return;
+    }
+
+    //ds solve and stop once the estimate does not move anymore
+    const PointCoordinates world_coordinates = _information_matrix.ldlt().solve(_information_vector);
+    const real delta_squared = (world_coordinates-_world_coordinates).squaredNorm();
+    _world_coordinates = world_coordinates;
+    if (delta_squared < 1e-6) {
+      return;
+    }
+  }
+}
+
 void Landmark::merge(Landmark* landmark_) {
   if (landmark_ == this) {
     LOG_WARNING(std::cerr << "Landmark::merge|" << _identifier << "|received merge request to itself: " << landmark_ << std::endl)
@@ -166,6 +282,8 @@ void Landmark::merge(Landmark* landmark_) {
 
   //ds merge descriptors
   _descriptors.insert(_descriptors.end(), landmark_->_descriptors.begin(), landmark_->_descriptors.end());
+  _number_of_descriptors += landmark_->_number_of_descriptors;
+  while (thinOut(_descriptors, _descriptor_stride, _parameters->maximum_history_length));
   landmark_->_descriptors.clear();
 
   //ds compute new merged world coordinates
@@ -176,7 +294,16 @@ void Landmark::merge(Landmark* landmark_) {
   //ds update measurements
   _number_of_updates    += landmark_->_number_of_updates;
   _number_of_recoveries += landmark_->_number_of_recoveries;
+  _number_of_outliers   += landmark_->_number_of_outliers;
+  _information_matrix   += landmark_->_information_matrix;
+  _information_vector   += landmark_->_information_vector;
+  _world_coordinates_accumulated += landmark_->_world_coordinates_accumulated;
+  _number_of_measurements       += landmark_->_number_of_measurements;
+  _number_of_inliers_in_history += landmark_->_number_of_inliers_in_history;
   _measurements.insert(_measurements.end(), landmark_->_measurements.begin(), landmark_->_measurements.end());
+  while (thinOut(_measurements, _measurement_stride, _parameters->maximum_history_length)) {
+    _number_of_inliers_in_history /= 2;
+  }
   landmark_->_measurements.clear();
 
   //ds connect framepoint history (last update of this with origin of absorbed landmark)
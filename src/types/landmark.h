@@ -16,22 +16,27 @@ public:
 
   typedef std::map<const HBSTMatchable*, HBSTMatchable*> HBSTMatchableMemoryMap;
 
-  //ds a landmark measurement (used for position optimization)
+  //ds a landmark measurement (used for position optimization), only the rotation is stored in single precision to keep the history compact
+  //ds (its rounding error does not grow with the distance to the origin, unlike the one of translation and coordinates)
   struct Measurement {
-    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-    Measurement(const FramePoint* framepoint_): world_to_camera(framepoint_->frame()->worldToCameraLeft()),
+    Measurement(const FramePoint* framepoint_): world_to_camera_rotation(framepoint_->frame()->worldToCameraLeft().linear().cast<float>()),
+                                                world_to_camera_translation(framepoint_->frame()->worldToCameraLeft().translation()),
                                                 camera_coordinates(framepoint_->cameraCoordinatesLeft()),
-                                                world_coordinates(framepoint_->worldCoordinates()),
                                                 inverse_depth_meters(1/framepoint_->cameraCoordinatesLeft().z()) {}
 
-    Measurement(): world_to_camera(TransformMatrix3D::Identity()),
+    Measurement(): world_to_camera_rotation(Eigen::Matrix3f::Identity()),
+                   world_to_camera_translation(Vector3::Zero()),
                    camera_coordinates(PointCoordinates::Zero()),
-                   world_coordinates(PointCoordinates::Zero()),
                    inverse_depth_meters(0) {}
 
-    TransformMatrix3D world_to_camera;
+    //! @brief transforms world coordinates into the camera frame of the measurement
+    inline PointCoordinates toCamera(const PointCoordinates& world_coordinates_) const {
+      return world_to_camera_rotation.cast<real>()*world_coordinates_+world_to_camera_translation;
+    }
+
+    Eigen::Matrix3f world_to_camera_rotation;
+    Vector3 world_to_camera_translation;
     PointCoordinates camera_coordinates;
-    PointCoordinates world_coordinates;
     real inverse_depth_meters;
   };
 
@@ -95,6 +100,26 @@ public:
 
   const std::set<LocalMap*>& localMaps() const {return _local_maps;}
 
+//ds helpers
+protected:
+
+  //! @brief adds a measurement to the accumulated information, robustly weighted with its error at the current estimate
+  //! @param[in] measurement_ the measurement to integrate
+  //! @return true if the measurement is an inlier at the current estimate, false otherwise
+  bool _addToInformation(const Measurement& measurement_);
+
+  //! @brief adds a measurement to the bounded measurement history
+  //! @param[in] measurement_ the measurement to add
+  void _addToHistory(const Measurement& measurement_);
+
+  //! @brief updates the landmark coordinates in constant time with a new measurement (incremental update)
+  //! @param[in] measurement_ the new measurement
+  void _updateIncremental(const Measurement& measurement_);
+
+  //! @brief rebuilds the accumulated information from the stored measurements with robust weights at the current estimate
+  //! @brief and solves for the landmark coordinates (iteratively re-weighted, cost linear in the history length)
+  void _resolveIncremental();
+
 //ds attributes
 protected:
 
@@ -109,7 +134,7 @@ protected:
   PointCoordinates _world_coordinates;
 
   //ds descriptors of this landmark which have not been converted to appearances yet
-  std::vector<cv::Mat> _descriptors;
+  DescriptorVector _descriptors;
 
   //ds appearances of this landmark that are captured in a local map (previously contained in _descriptors)
   HBSTMatchableMemoryMap _appearance_map;
@@ -125,6 +150,28 @@ protected:
   Count _number_of_updates    = 0;
   Count _number_of_recoveries = 0;
 
+  //! @brief bounded histories: every n-th measurement/descriptor is stored, n doubles whenever a history is thinned out
+  Count _measurement_stride    = 1;
+  Count _descriptor_stride     = 1;
+  Count _number_of_descriptors = 0;
+
+  //! @brief total number of measurements and number of inliers of the last accepted solution among the stored measurements
+  Count _number_of_measurements       = 0;
+  Count _number_of_inliers_in_history = 0;
+
+  //! @brief accumulated information of all measurements (incremental update): H = sum(R'*omega*R), b = sum(R'*omega*(p-t))
+  Matrix3 _information_matrix = Matrix3::Zero();
+  Vector3 _information_vector = Vector3::Zero();
+
+  //! @brief sum of all measured world coordinates (for the fallback estimate)
+  PointCoordinates _world_coordinates_accumulated = PointCoordinates::Zero();
+
+  //! @brief number of rejected measurements (incremental update)
+  Count _number_of_outliers = 0;
+
+  //! @brief robust kernel threshold for the landmark coordinates optimization
+  static constexpr real _maximum_error_squared_meters = 5*5;
+
   //ds grant access to landmark factory and helpers
   friend WorldMap;
   friend LocalMap;
@@ -57,11 +57,13 @@ LocalMap::LocalMap(FramePointerVector& frames_,
         //ds create HBST matchables based on available landmark descriptors TODO move this operation into a method of the landmark
         HBSTTree::MatchableVector matchables(landmark->_descriptors.size());
         for (Count u = 0; u < matchables.size(); ++u) {
-          HBSTMatchable* matchable = new HBSTMatchable(landmark, landmark->_descriptors[u], _identifier);
+          HBSTMatchable* matchable = new HBSTMatchable(landmark, landmark->_descriptors[u].toMat(), _identifier);
           matchables[u]            = matchable;
           landmark->_appearance_map.insert(std::make_pair(matchable, matchable));
         }
         landmark->_descriptors.clear();
+        landmark->_descriptor_stride     = 1;
+        landmark->_number_of_descriptors = 0;
         landmark->_local_maps.insert(this);
 
         //ds create a landmark snapshot and add it to the local map
@@ -76,10 +76,15 @@ void AlignerParameters::print() const {
   std::cerr << "AlignerParameters::print|maximum_error_kernel: " << maximum_error_kernel << std::endl;
   std::cerr << "AlignerParameters::print|minimum_number_of_inliers: " << minimum_number_of_inliers << std::endl;
   std::cerr << "AlignerParameters::print|minimum_inlier_ratio: " << minimum_inlier_ratio << std::endl;
+  std::cerr << "AlignerParameters::print|enable_parallel_linearization: " << enable_parallel_linearization << std::endl;
+  std::cerr << "AlignerParameters::print|maximum_time_seconds: " << maximum_time_seconds << std::endl;
 }
 
 void LandmarkParameters::print() const {
   std::cerr << "LandmarkParameters::print|minimum_number_of_forced_updates: " << minimum_number_of_forced_updates << std::endl;
+  std::cerr << "LandmarkParameters::print|enable_incremental_update: " << enable_incremental_update << std::endl;
+  std::cerr << "LandmarkParameters::print|incremental_resolve_interval: " << incremental_resolve_interval << std::endl;
+  std::cerr << "LandmarkParameters::print|maximum_history_length: " << maximum_history_length << std::endl;
 }
 
 void LocalMapParameters::print() const {
@@ -98,7 +103,17 @@ void BaseFramePointGeneratorParameters::print() const {
   std::cerr << "BaseFramepointGeneratorParameters::print|target_number_of_keypoints_tolerance: " << target_number_of_keypoints_tolerance << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|detector_threshold_minimum: " << detector_threshold_minimum << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|detector_threshold_maximum_change: " << detector_threshold_maximum_change << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|enable_parallel_keypoint_detection: " << enable_parallel_keypoint_detection << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|number_of_worker_threads: " << number_of_worker_threads << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|enable_lazy_descriptor_extraction: " << enable_lazy_descriptor_extraction << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|matching_distance_tracking_threshold: " << matching_distance_tracking_threshold << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|enable_pyramid_tracking: " << enable_pyramid_tracking << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|number_of_pyramid_levels: " << number_of_pyramid_levels << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|pyramid_search_radius_pixels: " << pyramid_search_radius_pixels << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|enable_adaptive_tracking_windows: " << enable_adaptive_tracking_windows << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|motion_uncertainty_translation_meters: " << motion_uncertainty_translation_meters << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|motion_uncertainty_rotation_radians: " << motion_uncertainty_rotation_radians << std::endl;
+  std::cerr << "BaseFramepointGeneratorParameters::print|minimum_adaptive_tracking_distance_pixels: " << minimum_adaptive_tracking_distance_pixels << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|enable_keypoint_binning: " << enable_keypoint_binning << std::endl;
   std::cerr << "BaseFramepointGeneratorParameters::print|bin_size_pixels: " << bin_size_pixels << std::endl;
 }
@@ -106,6 +121,11 @@ void BaseFramePointGeneratorParameters::print() const {
 void StereoFramePointGeneratorParameters::print() const {
   std::cerr << "StereoFramepointGeneratorParameters::print|maximum_matching_distance_triangulation: " << maximum_matching_distance_triangulation << std::endl;
   std::cerr << "StereoFramepointGeneratorParameters::print|minimum_disparity_pixels: " << minimum_disparity_pixels << std::endl;
+  std::cerr << "StereoFramepointGeneratorParameters::print|enable_parallel_stereo_extraction: " << enable_parallel_stereo_extraction << std::endl;
+  std::cerr << "StereoFramepointGeneratorParameters::print|enable_parallel_stereo_matching: " << enable_parallel_stereo_matching << std::endl;
+  std::cerr << "StereoFramepointGeneratorParameters::print|enable_parallel_tracking: " << enable_parallel_tracking << std::endl;
+  std::cerr << "StereoFramepointGeneratorParameters::print|enable_epipolar_right_detection: " << enable_epipolar_right_detection << std::endl;
+  std::cerr << "StereoFramepointGeneratorParameters::print|epipolar_right_full_detection_interval: " << epipolar_right_full_detection_interval << std::endl;
   BaseFramePointGeneratorParameters::print();
 }
 
@@ -125,6 +145,11 @@ BaseTrackerParameters::BaseTrackerParameters(const LoggingLevel& logging_level_)
 void BaseTrackerParameters::print() const {
   std::cerr << "BaseTrackerParameters::print|minimum_number_of_landmarks_to_track: " << minimum_number_of_landmarks_to_track << std::endl;
   std::cerr << "BaseTrackerParameters::print|maximum_number_of_landmark_recoveries: " << maximum_number_of_landmark_recoveries << std::endl;
+  std::cerr << "BaseTrackerParameters::print|enable_parallel_landmark_updates: " << enable_parallel_landmark_updates << std::endl;
+  std::cerr << "BaseTrackerParameters::print|number_of_worker_threads: " << number_of_worker_threads << std::endl;
+  std::cerr << "BaseTrackerParameters::print|enable_ransac_pose_hypothesis: " << enable_ransac_pose_hypothesis << std::endl;
+  std::cerr << "BaseTrackerParameters::print|ransac_maximum_number_of_iterations: " << ransac_maximum_number_of_iterations << std::endl;
+  std::cerr << "BaseTrackerParameters::print|ransac_maximum_reprojection_error_pixels: " << ransac_maximum_reprojection_error_pixels << std::endl;
   aligner->print();
 }
 
@@ -330,6 +355,9 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, world_map, world_map_parameters, minimum_degrees_rotated_for_local_map, real)
     PARSE_PARAMETER(configuration, world_map, world_map_parameters, minimum_number_of_frames_for_local_map, Count)
     PARSE_PARAMETER(configuration, landmark, world_map_parameters->landmark, minimum_number_of_forced_updates, Count)
+    PARSE_PARAMETER(configuration, landmark, world_map_parameters->landmark, enable_incremental_update, bool)
+    PARSE_PARAMETER(configuration, landmark, world_map_parameters->landmark, incremental_resolve_interval, Count)
+    PARSE_PARAMETER(configuration, landmark, world_map_parameters->landmark, maximum_history_length, Count)
     PARSE_PARAMETER(configuration, local_map, world_map_parameters->local_map, minimum_number_of_landmarks, Count)
 
     //ds mode specific parameters
@@ -344,6 +372,11 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
         PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, maximum_matching_distance_triangulation, int32_t)
         PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, minimum_disparity_pixels, real)
         PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, maximum_epipolar_search_offset_pixels, int32_t)
+        PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, enable_parallel_stereo_extraction, bool)
+        PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, enable_parallel_stereo_matching, bool)
+        PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, enable_parallel_tracking, bool)
+        PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, enable_epipolar_right_detection, bool)
+        PARSE_PARAMETER(configuration, stereo_framepoint_generation, stereo_framepoint_generator_parameters, epipolar_right_full_detection_interval, Count)
         break;
       }
       case CommandLineParameters::TrackerMode::RGB_DEPTH: {
@@ -369,6 +402,9 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, detector_threshold_maximum_change, real)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, number_of_detectors_vertical, int32_t)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, number_of_detectors_horizontal, int32_t)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, enable_parallel_keypoint_detection, bool)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, number_of_worker_threads, int32_t)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, enable_lazy_descriptor_extraction, bool)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, matching_distance_tracking_threshold, int32_t)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, maximum_reliable_depth_meters, real)
 
@@ -377,18 +413,32 @@ void ParameterCollection::parseFromFile(const std::string& filename_) {
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, minimum_number_of_landmarks_to_track, Count)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, minimum_projection_tracking_distance_pixels, int32_t)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, maximum_projection_tracking_distance_pixels, int32_t)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, enable_pyramid_tracking, bool)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, number_of_pyramid_levels, uint32_t)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, pyramid_search_radius_pixels, int32_t)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, enable_adaptive_tracking_windows, bool)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, motion_uncertainty_translation_meters, real)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, motion_uncertainty_rotation_radians, real)
+    PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, minimum_adaptive_tracking_distance_pixels, int32_t)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, tunnel_vision_ratio, real)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, maximum_number_of_landmark_recoveries, Count)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, enable_keypoint_binning, bool)
     PARSE_PARAMETER(configuration, base_framepoint_generation, framepoint_generation_parameters, bin_size_pixels, Count)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, minimum_delta_angular_for_movement, real)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, minimum_delta_translational_for_movement, real)
+    PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, enable_parallel_landmark_updates, bool)
+    PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, number_of_worker_threads, int32_t)
+    PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, enable_ransac_pose_hypothesis, bool)
+    PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, ransac_maximum_number_of_iterations, Count)
+    PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, ransac_maximum_reprojection_error_pixels, real)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, aligner->error_delta_for_convergence, real)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, aligner->maximum_error_kernel, real)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, aligner->damping, real)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, aligner->maximum_number_of_iterations, Count)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, aligner->minimum_number_of_inliers, Count)
     PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, aligner->minimum_inlier_ratio, real)
+    PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, aligner->enable_parallel_linearization, bool)
+    PARSE_PARAMETER(configuration, base_tracking, tracker_parameters, aligner->maximum_time_seconds, real)
 
     //ds parse desired motion model as string
     const std::string& motion_model = configuration["base_tracking"]["motion_model"].as<std::string>();
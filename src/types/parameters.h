@@ -96,6 +96,13 @@ public:
 
   //! @brief the minimum ratio of inliers to outliers required for a valid alignment
   real minimum_inlier_ratio          = 0.5;
+
+  //! @brief linearize the measurements in parallel chunks (requires worker threads of the owner, e.g. the tracker)
+  bool enable_parallel_linearization = false;
+
+  //! @brief time budget for a single alignment, afterwards the best pose found so far is returned (0: unbounded)
+  //! @brief only intended for real-time deployments, offline runs should not trade accuracy for latency
+  real maximum_time_seconds          = 0;
 };
 
 //! @class landmark parameters
@@ -110,6 +117,18 @@ public:
 
   //! @brief minimum number of measurements before optimization is filtering
   Count minimum_number_of_forced_updates = 2;
+
+  //! @brief enables constant time landmark updates from accumulated measurement information
+  //! @brief instead of a complete re-optimization over all measurements on every update
+  bool enable_incremental_update = false;
+
+  //! @brief incremental updates: number of measurements after which all stored measurements are robustly re-weighted
+  //! @brief at the current estimate and the coordinates are re-solved (0: robust weights stay fixed after integration)
+  Count incremental_resolve_interval = 10;
+
+  //! @brief maximum number of stored measurements and descriptors per landmark (0: unbounded)
+  //! @brief longer histories are subsampled uniformly over the track
+  Count maximum_history_length = 0;
 };
 
 //! @class local map parameters
@@ -167,6 +186,7 @@ public:
   virtual void print() const;
 
   //! @brief desired descriptor type (OpenCV string + bit size): BRIEF-256, ORB-256, BRISK-512, FREAK-512, ..
+  //! @brief or BRIEF-256-NATIVE for the built-in single level extractor (opt-in, no OpenCV pyramid and orientation computation)
   std::string descriptor_type = "ORB-256";
 
   //! @brief dynamic thresholds for feature detection
@@ -182,10 +202,33 @@ public:
   //! @brief number of camera image streams (required for detector regions)
   uint32_t number_of_cameras = 1;
 
+  //! @brief parallel keypoint detection over the detector grid (each detector region is processed by a worker thread)
+  bool enable_parallel_keypoint_detection = false;
+
+  //! @brief number of threads used for parallel processing (0: all available hardware threads)
+  uint32_t number_of_worker_threads = 0;
+
+  //! @brief extract descriptors on demand: a descriptor is computed the first time a matcher compares the feature
+  //! @brief instead of for every detected keypoint (only supported for BRIEF-256-NATIVE)
+  bool enable_lazy_descriptor_extraction = false;
+
   //! @brief point tracking thresholds
   int32_t minimum_projection_tracking_distance_pixels = 15;
   int32_t maximum_projection_tracking_distance_pixels = 50;
 
+  //! @brief pyramid tracking: the predicted projection of each point is refined coarse to fine by patch alignment
+  //! @brief in the left image pyramids (search radius per level), the final search uses the minimum tracking distance
+  bool enable_pyramid_tracking         = false;
+  uint32_t number_of_pyramid_levels    = 4;
+  int32_t pyramid_search_radius_pixels = 3;
+
+  //! @brief adaptive tracking windows: the search window of each point is derived from the motion uncertainty and its depth
+  //! @brief (first order image displacement), scaled by the projection tracking distance relative to its minimum
+  bool enable_adaptive_tracking_windows             = false;
+  real motion_uncertainty_translation_meters        = 0.1;
+  real motion_uncertainty_rotation_radians          = 0.01;
+  int32_t minimum_adaptive_tracking_distance_pixels = 4;
+
   //! @brief dynamic thresholds for descriptor matching
   int32_t matching_distance_tracking_threshold = 0.2*SRRG_PROSLAM_DESCRIPTOR_SIZE_BITS;
 
@@ -215,6 +258,21 @@ public:
 
   //! @brief maximum checked epipolar line offsets
   int32_t maximum_epipolar_search_offset_pixels  = 0;
+
+  //! @brief concurrent feature extraction in the left and right image (each stream has its own detector thresholds)
+  bool enable_parallel_stereo_extraction = false;
+
+  //! @brief parallel epipolar stereo matching over horizontal bands of image rows (identical result as sequential matching)
+  bool enable_parallel_stereo_matching = false;
+
+  //! @brief parallel track matching for all previous framepoints (conflicting matches are resolved sequentially, identical result)
+  bool enable_parallel_tracking = false;
+
+  //! @brief detect keypoints in the right image only where they can be matched by a left keypoint (epipolar rows, non negative disparity)
+  //! @brief the right stream adapts its thresholds to the extrapolated keypoint counts, every interval images a complete detection
+  //! @brief resynchronizes them with the actual counts (0: never)
+  bool enable_epipolar_right_detection          = false;
+  Count epipolar_right_full_detection_interval  = 10;
 };
 
 //! @class framepoint generation parameters for a rgbd camera setup
@@ -267,6 +325,19 @@ public:
   //! @brief desired motion model (if any)
   MotionModel motion_model = MotionModel::CONSTANT_VELOCITY;
 
+  //! @brief parallel landmark updates (landmarks are created and linked serially, their coordinates are refined in parallel)
+  bool enable_parallel_landmark_updates = false;
+
+  //! @brief number of threads used for parallel landmark updates and pose optimization (0: all available hardware threads)
+  //! @brief only used if the framepoint generator has no worker threads to share
+  uint32_t number_of_worker_threads = 0;
+
+  //! @brief pose hypothesis stage: the best of the motion prior and minimal 3 point hypotheses on the triangulated correspondences
+  //! @brief (RANSAC, scored by the reprojection error in the left image) initializes the pose optimization together with its inliers
+  bool enable_ransac_pose_hypothesis            = false;
+  Count ransac_maximum_number_of_iterations     = 100;
+  real ransac_maximum_reprojection_error_pixels = 4;
+
   //! @brief parameters of aligner unit
   AlignerParameters* aligner;
 };
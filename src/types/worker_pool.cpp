@@ -0,0 +1,107 @@
+#include "worker_pool.h"
+
+namespace proslam {
+
+WorkerPool::WorkerPool(const Count& number_of_threads_) {
+  Count number_of_threads = number_of_threads_;
+
+  //ds use all available hardware threads if not specified
+  if (number_of_threads == 0) {
+    number_of_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  //ds the calling thread participates in every run
+  for (Index u = 1; u < number_of_threads; ++u) {
+    _workers.push_back(std::thread(&WorkerPool::_work, this));
+  }
+  LOG_INFO(std::cerr << "WorkerPool::WorkerPool|constructed (threads: " << numberOfThreads() << ")" << std::endl)
+}
+
+WorkerPool::~WorkerPool() {
+  LOG_INFO(std::cerr << "WorkerPool::~WorkerPool|destroying" << std::endl)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _is_terminating = true;
+  }
+  _job_available.notify_all();
+  for (std::thread& worker: _workers) {
+    worker.join();
+  }
+  LOG_INFO(std::cerr << "WorkerPool::~WorkerPool|destroyed" << std::endl)
+}
+
+void WorkerPool::run(const Count& number_of_jobs_, const std::function<void(const Index&)>& job_) {
+
+  //ds process sequentially if there is nothing to distribute
+  if (_workers.empty() || number_of_jobs_ < 2) {
+    for (Index index = 0; index < number_of_jobs_; ++index) {
+      job_(index);
+    }
+    return;
+  }
+
+  //ds publish the batch to the workers
+  Batch batch(number_of_jobs_, job_);
+  std::unique_lock<std::mutex> lock(_mutex);
+  _batches.push_back(&batch);
+  _job_available.notify_all();
+
+  //ds participate in the processing until all jobs of our batch are claimed
+  while (batch.number_of_jobs_claimed < batch.number_of_jobs) {
+    const Index index = batch.number_of_jobs_claimed;
+    ++batch.number_of_jobs_claimed;
+    if (batch.number_of_jobs_claimed == batch.number_of_jobs) {
+      _batches.erase(std::find(_batches.begin(), _batches.end(), &batch));
+    }
+    lock.unlock();
+    job_(index);
+    lock.lock();
+    ++batch.number_of_jobs_completed;
+  }
+
+  //ds wait for the jobs still processed by the workers
+  _job_completed.wait(lock, [&batch]{return batch.number_of_jobs_completed == batch.number_of_jobs;});
+}
+
+bool WorkerPool::_claimJob(Batch*& batch_, Index& index_) {
+  if (_batches.empty()) {
+    return false;
+  }
+
+  //ds claim the next job of the oldest batch and retire the batch if this was its last job
+  batch_ = _batches.front();
+  index_ = batch_->number_of_jobs_claimed;
+  ++batch_->number_of_jobs_claimed;
+  if (batch_->number_of_jobs_claimed == batch_->number_of_jobs) {
+    _batches.pop_front();
+  }
+  return true;
+}
+
+void WorkerPool::_work() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+
+    //ds wait for work or termination
+    _job_available.wait(lock, [this]{return _is_terminating || !_batches.empty();});
+    if (_is_terminating) {
+      return;
+    }
+
+    //ds process a single job without holding the lock
+    Batch* batch = nullptr;
+    Index index  = 0;
+    if (_claimJob(batch, index)) {
+      lock.unlock();
+      batch->job(index);
+      lock.lock();
+
+      //ds the batch must not be accessed after the completion is signaled
+      ++batch->number_of_jobs_completed;
+      if (batch->number_of_jobs_completed == batch->number_of_jobs) {
+        _job_completed.notify_all();
+      }
+    }
+  }
+}
+} //namespace proslam
@@ -0,0 +1,83 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <algorithm>
+#include "definitions.h"
+
+namespace proslam {
+
+//! @class minimal pool of persistent worker threads for data parallel sections
+//! the calling thread always participates in the processing of its own jobs, which makes nested calls (e.g. parallel
+//! detection within a parallel stereo extraction) safe - jobs are claimed in index order and results must be written
+//! into job-specific buffers by the caller to obtain a deterministic outcome
+class WorkerPool {
+
+//ds object handling
+public:
+
+  //! @brief constructs a pool with the desired number of threads (including the calling thread)
+  //! @param[in] number_of_threads_ total number of threads processing jobs, 0: use all available hardware threads
+  WorkerPool(const Count& number_of_threads_ = 0);
+
+  //! @brief prohibit copying of the pool
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  //! @brief joins all worker threads
+  ~WorkerPool();
+
+//ds functionality
+public:
+
+  //! @brief runs job_(index) for all indices in [0, number_of_jobs_) and blocks until all jobs are completed
+  //! @param[in] number_of_jobs_ number of jobs to process
+  //! @param[in] job_ job function, has to be safe to be called concurrently for different indices
+  void run(const Count& number_of_jobs_, const std::function<void(const Index&)>& job_);
+
+//ds getters/setters
+public:
+
+  //! @brief total number of threads processing jobs (including the calling thread)
+  const Count numberOfThreads() const {return _workers.size()+1;}
+
+//ds helpers
+protected:
+
+  //! @brief a set of jobs issued by a single run call
+  struct Batch {
+    Batch(const Count& number_of_jobs_, const std::function<void(const Index&)>& job_): number_of_jobs(number_of_jobs_),
+                                                                                         job(job_) {}
+    const Count number_of_jobs;
+    const std::function<void(const Index&)>& job;
+    Count number_of_jobs_claimed   = 0;
+    Count number_of_jobs_completed = 0;
+  };
+
+  //! @brief claims the next job of the oldest pending batch (must be called with a locked _mutex)
+  //! @param[out] batch_ batch of the claimed job
+  //! @param[out] index_ index of the claimed job
+  //! @return true if a job was claimed, false otherwise
+  bool _claimJob(Batch*& batch_, Index& index_);
+
+  //! @brief processing loop of a worker thread
+  void _work();
+
+//ds attributes
+protected:
+
+  //! @brief worker threads (the calling thread is not part of this)
+  std::vector<std::thread> _workers;
+
+  //! @brief pending batches, a batch is removed as soon as all its jobs are claimed
+  std::deque<Batch*> _batches;
+
+  //! @brief synchronization
+  std::mutex _mutex;
+  std::condition_variable _job_available;
+  std::condition_variable _job_completed;
+  bool _is_terminating = false;
+};
+} //namespace proslam